@@ -15,11 +15,22 @@
 #include <vtkContextScene.h>
 #include <vtkPen.h>
 #include <vtkNamedColors.h>
+#include <vtkCommand.h>
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_decimation.h"
+#include "VTK_output.h"
+#include "VTK_colours.h"
+#include "VTK_instrumentation.h"
 
 /* External modules */
 #include <vector>
 #include <string>
 #include <iostream>
+#include <memory>
+#include <cstring>
+#include <unordered_set>
 
 
 // Namespace "wrapped visualization toolkit" 
@@ -33,483 +44,657 @@ namespace W_VTK {
 		};
 
 		/* =-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-= */
-		/* ------------------- 2D Line plotters: Stack memory variant (memory must be known at compile time) ----------------- */
+		/* ------------------- 2D plotters: Runtime sized variant (memory only known at run time) ---------------------------- */
 		/* =-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-= */
 
-		/*=================================================================================================================
-		Plot N number of lines with data points sharing the same X coordinates for each data set.
-		=================================================================================================================== */
-		template<int numPoints, int numLines> 		// Line properties are random colours and width of 1.0 
-		void Line_plotter(std::string(&names)[numLines], float(&x_pos)[numPoints], float(&data)[numLines][numPoints]) {
+		/* ----- Notes -----:
+		Data comes in as series_views (std::vector, std::span, pointer + length or strided pointer) of float, double, int32,
+		int16 or uint8 values. Each collumn is the VTK array of the data's own type (vtkDoubleArray, vtkTypeInt16Array, ...),
+		so e.g. int16 ADC samples against a double time axis are plotted without a float copy. Level of detail works in float
+		and converts other types as it decimates.
+		The standalone plotters BORROW contiguous data by default so nothing is copied: the data only has to live until the
+		window is closed. The chart variants COPY by default as the chart outlives the call (a temporary std::vector would
+		be gone before it is drawn), pass BORROW for data that lives until multiplot_view_window returns.
+		Strided views are gathered into a new collumn (the only copy made).
+		Line plotters take optional LOD::Settings: with MIN_MAX or LTTB every line is first reduced to the pixel budget
+		(in parallel across lines, see VTK_decimation.h) so huge traces don't turn into millions of segments per frame.
+		Standalone plotters (and multiplot_view_window) take an optional RenderTarget last: the default opens the interactive
+		window as before, RenderTarget::Png / RenderTarget::Rgba render headless with no view or interactor (see VTK_output.h).
+		The runtime standalone plotters return false when the data is rejected (see std::cerr) or the headless image isn't
+		written, multiplot_view_window when its headless image isn't written.
+		The fixed size (stack memory) variants further down forward to these. */
+
+		/* Background of the standalone plotters (white) */
+		const double default_background[3] = { 1.0, 1.0, 1.0 };
+
+		/* Runtime sizes can't be checked by the compiler so check them before VTK sees the data. */
+		inline bool series_size_check(const char* caller, size_t expected, size_t actual, const char* what) {
+
+			if (expected != actual) {
+				std::cerr << "W_VTK::_2D::" << caller << ": " << what << " has " << actual << " entries, expected " << expected << "\n";
+				return false;
+			}
+			return true;
+		}
+
+		/* =================================================================================================================
+		Plot N number of lines where data points have different X coordinates for each data set.
+		Each line gets its own vtkTable so lines may have different numbers of points.
+		(Comes first as the shared X variant hands decimated lines to it.)
+		=================================================================================================================  */
+		inline bool Line_plotter(const std::vector<std::string>& names, const std::vector<series_view>& x_pos, const std::vector<series_view>& data, Ingestion mode = BORROW, const LOD::Settings& lod = LOD::Settings(), const RenderTarget& target = RenderTarget()) {
 
 			/* ----- Notes -----:
-			Input data		-> rows = Line number, cols = points on lines
-			vtKtable data	-> rows = points on lines, cols = Line number
-			YOU HAVE TO NAME YOUR LINES AND YOU HAVE TO NAME THEM DIFFERENTLY
-			*/
+			names			-> one per line, or 2 * lines (x collumn names first then line names, as the fixed size variant)
+			x_pos, data		-> one series_view per line, x_pos[j] and data[j] must be the same size
+			YOU HAVE TO NAME YOUR LINES AND YOU HAVE TO NAME THEM DIFFERENTLY */
 
-			// Create a table with some points in it
-			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+			Instrumentation::Scope instrumentation("_2D::Line_plotter");
 
-			// Instantiate an array of vtkFloatArray type. (Holds line data )
-			vtkSmartPointer<vtkFloatArray> arr[numLines + 1];
+			const int numLines = static_cast<int>(data.size());
+			const bool namedX = (names.size() == 2 * data.size());
+			if (!series_size_check("Line_plotter", data.size(), x_pos.size(), "x_pos")) { return false; }
+			if (!namedX && !series_size_check("Line_plotter", data.size(), names.size(), "names")) { return false; }
+			for (int j = 0; j < numLines; j++) {
+				if (!series_size_check("Line_plotter", x_pos[j].size, data[j].size, "data")) { return false; }
+			}
 
-			// Instantiate the x-axis (Cant use condition in allocation loop for some reason...)
-			arr[X_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[X_axis]->SetName("X-axis");
-			table->AddColumn(arr[X_axis]);
+			// Level of detail: reduce every line to the pixel budget (in parallel) then plot the reduced lines
+			if (lod.method != LOD::NONE) {
+				Instrumentation::Stage_timer conversion(Instrumentation::CONVERSION);
+				std::vector<LOD::Series> reduced = LOD::decimate(x_pos, data, lod);
+				// Strided views stay the caller's (see make_float_column) and memory viewed by several lines is released once
+				std::unordered_set<const void*> released;
+				for (int j = 0; j < numLines; j++) {
+					if (x_pos[j].stride == 1 && released.insert(x_pos[j].values).second) {
+						release_unwrapped(x_pos[j], block_row_mode(mode, j));
+					}
+					if (data[j].stride == 1 && released.insert(data[j].values).second) {
+						release_unwrapped(data[j], block_row_mode(mode, j));
+					}
+				}
 
-			// Allocate float array data and give names. Note numLines + 1 as you have to include x-axis. 
-			for (int j = 1; j < numLines + 1; j++) {
+				std::vector<series_view> x_rows, rows;
+				LOD::views(reduced, x_rows, rows);
+				conversion.stop();
+				return Line_plotter(names, x_rows, rows, BORROW, LOD::Settings(), target);
+			}
 
-				// Allocate float array data
-				arr[j] = vtkSmartPointer<vtkFloatArray>::New();
+			// Add multiple line plots, setting the colors etc
+			vtkSmartPointer<vtkChartXY> chart = vtkSmartPointer<vtkChartXY>::New();
 
-				// NAMING LINES MATTERS BECAUSE IF YOU DONT VTK WONT WORK. THEY ALSO NEED DIFFERENT NAMES.
-				arr[j]->SetName(names[j - 1].c_str());	// j-1 to offset data (as x-axis was added)
+			// Deterministic series colours (seed with Palette::set_default_seed)
+			Palette palette;
 
-				// Add collumn to vtkTable with vtkFloatarray memory 
-				table->AddColumn(arr[j]);
+			// Loop over lines and input data to vtkLine for plotting: Line -> chart -> view -> Renderwindow, Interactor
+			for (int j = 0; j < numLines; j++) {
+
+				const std::string& lineName = namedX ? names[j + numLines] : names[j];
+				const std::string xName = namedX ? names[j] : "X: " + names[j];
+
+				// Table per line: col 0 -> x, col 1 -> data
+				Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+				vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+				table->AddColumn(make_column(xName.c_str(), x_pos[j], block_row_mode(mode, j)));
+				table->AddColumn(make_column(lineName.c_str(), data[j], block_row_mode(mode, j)));
+				table_timer.stop();
+
+				Instrumentation::Stage_timer plot_layout(Instrumentation::LAYOUT);
+
+				vtkPlot* line = chart->AddPlot(vtkChart::LINE);
+				line->SetInputData(table, 0, 1);
+
+				// Line properties
+				line->GetPen()->SetColorF(palette.next().GetData());
+				line->SetWidth(1.0);
 			}
 
-			// Set number of rows on table for number of points 
-			table->SetNumberOfRows(numPoints);
+			Instrumentation::update_measured(chart.GetPointer());
 
-			// Set/transform raw data to vtkTable 
-			for (int i = 0; i < numLines; i++) {
-				for (int j = 0; j < numPoints; j++) {
-					table->SetValue(j, 0, x_pos[j]);		// Recall x axis is vtkTable col [0].
-					table->SetValue(j, i + 1, data[i][j]);	// Access data col-wise for efficiency (col0,col1,col2,col3 etc..) 
-															// i+1 to put data on correct collumns on vtkTable
-				}
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(chart, default_background, target);
 			}
 
 			// Set up the view
 			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
 			view->GetRenderer()->SetBackground(1.0, 1.0, 1.0);
-
-			// Add multiple line plots, setting the colors etc
-			vtkSmartPointer<vtkChartXY> chart = vtkSmartPointer<vtkChartXY>::New();
 			view->GetScene()->AddItem(chart);
 
-			// Instantiate a vtkLine object 
-			vtkPlot* line = chart->AddPlot(vtkChart::LINE);
-
-			// RGB array for random colours for plotting multiple lines 
-			double RGB[3]; 
-
-			// Loop over lines and input data to vtkLine for plotting: Line -> chart -> view -> Renderwindow, Interactor
-			for (int j = 1; j < numLines + 1; j++)
-			{
-				// Add a plot for each line after first iteration. 
-				if (j > 1) {
-					line = chart->AddPlot(vtkChart::LINE);
-				}
-				line->SetInputData(table, 0, j);
-				
-				// Line properties
-				RGB[0] = std::rand() % 255;
-				RGB[1] = std::rand() % 255;
-				RGB[2] = std::rand() % 255;
-				line->SetColor(RGB[0],RGB[1],RGB[2]);
-				line->SetWidth(1.0);
-			}
-
-			// Start interactor and render window
+			// Start interactor
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
 			view->GetRenderWindow()->Render();
+			render_timer.stop();
+			instrumentation.finish();
 			view->GetInteractor()->Initialize();
 			view->GetInteractor()->Start();
+			return true;
 		}
 
-
-		/* =================================================================================================================
-		Plot N number of lines where data points have different X coordinates for each data set.
-		Note: Good for automating plotting for alot of lines from big data. (i.e. if you want to plot 100 lines from data)
-		=================================================================================================================  */
-
-		/* Function to generate generic line names for any amount of lines in a plot.
-		   - VTK requires lines to be named and to be different names!					*/
-		template<int no_of_names> 
-		void LineNameGenerator(std::string(&names)[no_of_names]) {
-
-			for (int i = 0; i < no_of_names; i++) {
-				names[i] = "Line: " + std::to_string(i);
-			}
-		}
-
-		template<int numPoints, int numLines>			// Line properties are random colours and width of 1.0 
-		void Line_plotter(std::string(&names)[2 * numLines], float(&x_pos)[numLines][numPoints], float(&data)[numLines][numPoints]) {
+		/*=================================================================================================================
+		Plot N number of lines with data points sharing the same X coordinates for each data set.
+		=================================================================================================================== */
+		inline bool Line_plotter(const std::vector<std::string>& names, series_view x_pos, const std::vector<series_view>& data, Ingestion mode = BORROW, const LOD::Settings& lod = LOD::Settings(), const RenderTarget& target = RenderTarget()) {
 
 			/* ----- Notes -----:
-			Input data		-> rows = Line number, cols = points on lines
-			vtKtable data	-> rows = points on lines, cols = Line number
-			YOU HAVE TO NAME YOUR LINES AND YOU HAVE TO NAME THEM DIFFERENTLY */
-
-			// Create a tablefor array data
-			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
-
-			// Instantiate an array of vtkFloatArray type. (Holds line data )
-			vtkSmartPointer<vtkFloatArray> arr[2 * numLines];
+			names			-> one per line
+			data			-> one series_view per line, each with as many points as x_pos
+			YOU HAVE TO NAME YOUR LINES AND YOU HAVE TO NAME THEM DIFFERENTLY
+			*/
 
-			// Allocate float array data and give names. Note numLines + 1 as you have to include x-axis. 
-			for (int j = 0; j < 2 * numLines; j++) {
+			Instrumentation::Scope instrumentation("_2D::Line_plotter");
 
-				// Allocate float array data
-				arr[j] = vtkSmartPointer<vtkFloatArray>::New();
+			const int numLines = static_cast<int>(data.size());
+			if (!series_size_check("Line_plotter", data.size(), names.size(), "names")) { return false; }
+			for (int j = 0; j < numLines; j++) {
+				if (!series_size_check("Line_plotter", x_pos.size, data[j].size, names[j].c_str())) { return false; }
+			}
 
-				// NAMING LINES MATTERS BECAUSE IF YOU DONT VTK WONT WORK. THEY ALSO NEED DIFFERENT NAMES. 
-				arr[j]->SetName(names[j].c_str());
+			// Level of detail: reduce every line to the pixel budget before building any table.
+			// Decimated lines no longer share x coordinates so they go through the different-X variant (reduced data is borrowed,
+			// it lives until that call returns when the window is closed).
+			if (lod.method != LOD::NONE) {
+				Instrumentation::Stage_timer conversion(Instrumentation::CONVERSION);
+				std::vector<LOD::Series> reduced = LOD::decimate(x_pos, data, lod);
+				// Strided views stay the caller's (see make_float_column)
+				if (x_pos.stride == 1) {
+					release_unwrapped(x_pos, mode);
+				}
+				for (int j = 0; j < numLines; j++) {
+					if (data[j].stride == 1) {
+						release_unwrapped(data[j], block_row_mode(mode, j));
+					}
+				}
 
-				// Add collumn to vtkTable with vtkFloatarray memory 
-				table->AddColumn(arr[j]);
+				std::vector<series_view> x_rows, rows;
+				LOD::views(reduced, x_rows, rows);
+				conversion.stop();
+				return Line_plotter(names, x_rows, rows, BORROW, LOD::Settings(), target);
 			}
 
-			// Set number of rows on table for number of points 
-			table->SetNumberOfRows(numPoints);
+			// Create a table with some points in it
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
 
-			// Set/transform raw data to vtkTable (rows -> pts, cols -> Lines : The way VTK data works..) 
-			for (int i = 0; i < numLines; i++) {
-				for (int j = 0; j < numPoints; j++) {
+			// Instantiate the x-axis. Recall x axis is vtkTable col [0].
+			table->AddColumn(make_column("X-axis", x_pos, mode));
 
-					table->SetValue(j, i, x_pos[i][j]);
-					table->SetValue(j, i + numLines, data[i][j]);	// Accss data col-wise for efficiency (col0,col1,col2,col3 etc..) 
-				}
+			// One collumn per line (j+1 on vtkTable as x-axis was added)
+			// NAMING LINES MATTERS BECAUSE IF YOU DONT VTK WONT WORK. THEY ALSO NEED DIFFERENT NAMES. 
+			for (int j = 0; j < numLines; j++) {
+				table->AddColumn(make_column(names[j].c_str(), data[j], block_row_mode(mode, j)));
 			}
-
-			// Set up the view
-			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
-			view->GetRenderer()->SetBackground(1.0, 1.0, 1.0);
+			table_timer.stop();
 
 			// Add multiple line plots, setting the colors etc
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
 			vtkSmartPointer<vtkChartXY> chart = vtkSmartPointer<vtkChartXY>::New();
-			view->GetScene()->AddItem(chart);
-
-			// Instantiate a vtkLine object 
-			vtkPlot* line = chart->AddPlot(vtkChart::LINE);
 
-			// RGB array for line colour data 
-			double RGB[3];
+			// Deterministic series colours (seed with Palette::set_default_seed)
+			Palette palette;
 
 			// Loop over lines and input data to vtkLine for plotting: Line -> chart -> view -> Renderwindow, Interactor
-			for (int j = 0; j < numLines; j++) {
+			for (int j = 1; j < numLines + 1; j++) {
 
-				// Add a plot for each line after first iteration. 
-				if (j > 0) {
-					line = chart->AddPlot(vtkChart::LINE);
-				}
-				line->SetInputData(table, j, j + numLines);
+				vtkPlot* line = chart->AddPlot(vtkChart::LINE);
+				line->SetInputData(table, 0, j);
 
 				// Line properties
-				RGB[0] = std::rand() % 255;
-				RGB[1] = std::rand() % 255;
-				RGB[2] = std::rand() % 255;
-				line->SetColor(RGB[0], RGB[1], RGB[2]);
+				line->GetPen()->SetColorF(palette.next().GetData());
 				line->SetWidth(1.0);
 			}
 
-			// Start interactor
+			layout.stop();
+			Instrumentation::update_measured(chart.GetPointer());
+
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(chart, default_background, target);
+			}
+
+			// Set up the view
+			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
+			view->GetRenderer()->SetBackground(1.0, 1.0, 1.0);
+			view->GetScene()->AddItem(chart);
+
+			// Start interactor and render window
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
 			view->GetRenderWindow()->Render();
+			render_timer.stop();
+			instrumentation.finish();
 			view->GetInteractor()->Initialize();
 			view->GetInteractor()->Start();
+			return true;
 		}
 
-
 		/* =================================================================================================================
-		Plotting single lines on the same render window (Lines not together in memory (e.g. data_set_1[10], data_set_2[10]))
-		Note: Works with different X coordinates for each data set.
+		Zoom-aware level of detail: observer that re-decimates one line every time the chart's x-axis range changes (zoom/pan).
+		The full resolution line sits in a LOD::ZoomIndex so only the visible window is decimated, at O(buckets) cost.
+		The observer is held by the axis' observer list so it lives exactly as long as the chart.
 		================================================================================================================= */
+		class ZoomRedecimation : public vtkCommand {
 
-		// Function to instatiate a vtkChart data structure for containing line plot data
-		/* From documentation:	"In this case the smart pointer automatically manages the reference it owns. When the smart pointer variable goes out-of-scope
-								and is no longer used, such as when a function in which it is a local variable returns, it automatically informs the object by
-								decrementing the reference count. By using the static New() method provided by the smart pointer no raw pointer ever needs to
-								hold a reference to the object, so no call to Delete() is needed."	*/
-		vtkSmartPointer<vtkChartXY> multiplot_chart_instantiation() {
+		public:
 
-			// Set up chart data structure
-			vtkSmartPointer<vtkChartXY> chart = vtkSmartPointer<vtkChartXY>::New();
+			static ZoomRedecimation* New() { return new ZoomRedecimation; }
 
-			return chart;
-		}
+			// Table holding the current decimated view (col 0 -> x, col 1 -> data)
+			vtkSmartPointer<vtkTable> table;
 
-		// Function to start the render window and interactor. 
-		void multiplot_view_window(vtkSmartPointer<vtkChartXY>& chart, const char* BackgroundColour, bool showLegend) {
+			/* Index the full resolution line and fill the table with the fully zoomed out view */
+			void Initialise(const series_view& x_pos, const series_view& data, const std::string& name, const LOD::Settings& lod, Ingestion mode) {
 
-			// vtkNamedColors:  A class holding colors and their names.
-			// For info see the folder with VTK_Coloursheets for different colour names. 
-			vtkSmartPointer<vtkNamedColors> colors = vtkSmartPointer<vtkNamedColors>::New();
+				pixels = lod.pixels;
+				index.reset(new LOD::ZoomIndex(x_pos, data, mode, lod.threads));
 
-			// Set up the view
-			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
-			view->GetRenderer()->SetBackground(colors->GetColor3d(BackgroundColour).GetData());	// Set the background to white
-			
-			// Show legend?
-			chart->SetShowLegend(showLegend);
+				X = vtkSmartPointer<vtkFloatArray>::New();
+				X->SetName("X-axis");
+				Y = vtkSmartPointer<vtkFloatArray>::New();
+				Y->SetName(name.c_str());
 
+				table = vtkSmartPointer<vtkTable>::New();
+				table->AddColumn(X);
+				table->AddColumn(Y);
 
-			// Add the chart to the view
-			view->GetScene()->AddItem(chart);
+				if (index->size() > 0) {
+					Redecimate(index->x()[0], index->x()[index->size() - 1]);
+				}
+			}
 
-			// Start interactor
-			view->GetRenderWindow()->Render();
-			view->GetInteractor()->Initialize();
-			view->GetInteractor()->Start();
-		}
+			/* vtkChart::UpdateRange from the x-axis */
+			void Execute(vtkObject* caller, unsigned long, void*) override {
 
+				vtkAxis* axis = static_cast<vtkAxis*>(caller);
+				Redecimate(axis->GetMinimum(), axis->GetMaximum());
+			}
 
-		// Single 2D Line creator which adds the plot of a 2D line to the inputted view
-		template<int numPoints>
-		void Line_plotter(vtkSmartPointer<vtkChartXY>& chart, float(&x_pos)[numPoints], float(&data)[numPoints], std::string& name, const char* LineColour, float width) {
+			/* Decimate [x0, x1] into the collumns in place. Only this plot's input is modified, the axes are left alone. */
+			void Redecimate(double x0, double x1) {
 
-			/* ----- Notes -----:
-			Input data		-> rows = Line number, cols = points on lines
-			vtKtable data	-> rows = points on lines, cols = Line number
-			YOU HAVE TO NAME YOUR LINES AND YOU HAVE TO NAME THEM DIFFERENTLY
-			*/
+				index->query(x0, x1, pixels, reduced);
 
-			// Create a table with some points in it
-			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+				const vtkIdType count = static_cast<vtkIdType>(reduced.y.size());
+				X->SetNumberOfTuples(count);
+				Y->SetNumberOfTuples(count);
+				if (count > 0) {
+					std::memcpy(X->GetPointer(0), reduced.x.data(), count * sizeof(float));
+					std::memcpy(Y->GetPointer(0), reduced.y.data(), count * sizeof(float));
+				}
+				X->Modified();
+				Y->Modified();
+				table->Modified();
+			}
 
-			// Instantiate an array of vtkFloatArray type. (Holds line data )
-			vtkSmartPointer<vtkFloatArray> arr[2];
+		private:
 
-			// Instantiate the x-axis (Cant use condition in allocation loop for some reason...)
-			arr[X_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[X_axis]->SetName("X-axis");
-			table->AddColumn(arr[X_axis]);
+			ZoomRedecimation() : pixels(0) {}
 
-			// Instantiate data for next line: 
-			// Allocate float array data and give name
-			arr[1] = vtkSmartPointer<vtkFloatArray>::New();			// Allocate float array data
-			arr[1]->SetName(name.c_str());									// Set name
-			table->AddColumn(arr[1]);								// Add collumn to vtkTable with vtkFloatarray memory 
+			size_t pixels;
+			std::unique_ptr<LOD::ZoomIndex> index;
+			vtkSmartPointer<vtkFloatArray> X, Y;
+			LOD::Series reduced;	// Reused between zooms
+		};
 
-			// Set number of rows on table for number of points 
-			table->SetNumberOfRows(numPoints);
+		/* =================================================================================================================
+		Single 2D Line creator which adds the plot of a 2D line to the inputted chart (see multiplot_chart_instantiation)
+		With lod.follow_zoom the line is re-decimated for the visible x window whenever the chart is zoomed or panned.
+		================================================================================================================= */
+		inline void Line_plotter(vtkSmartPointer<vtkChartXY>& chart, series_view x_pos, series_view data, const std::string& name, const char* LineColour, float width, Ingestion mode = COPY, const LOD::Settings& lod = LOD::Settings()) {
 
-			// Set/transform raw data to vtkTable 
+			Instrumentation::Scope instrumentation("_2D::Line_plotter");
+			if (!series_size_check("Line_plotter", x_pos.size, data.size, name.c_str())) { return; }
 
-			for (int i = 0; i < numPoints; i++) {
-				table->SetValue(i, 0, x_pos[i]);		// Recall x axis is vtkTable col [0].
-				table->SetValue(i, 1, data[i]);
+			// Create a table with some points in it
+			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+
+			// Zoom-aware level of detail: the observer owns the table and refills it on every x-axis range change
+			vtkSmartPointer<ZoomRedecimation> zoom;
+			if (lod.method != LOD::NONE && lod.follow_zoom) {
+				Instrumentation::Stage_timer conversion(Instrumentation::CONVERSION);
+				zoom = vtkSmartPointer<ZoomRedecimation>::New();
+				zoom->Initialise(x_pos, data, name, lod, mode);
+				table = zoom->table;
 			}
 
+			// Instantiate the x-axis (Recall x axis is vtkTable col [0]) and the data for the line.
+			// With level of detail on the reduced line is copied in (it is at most 2 points per pixel).
+			else if (lod.method != LOD::NONE) {
+				Instrumentation::Stage_timer conversion(Instrumentation::CONVERSION);
+				LOD::Series reduced;
+				LOD::decimate(x_pos, data, lod, reduced);
+				if (x_pos.stride == 1) {
+					release_unwrapped(x_pos, mode);
+				}
+				if (data.stride == 1) {
+					release_unwrapped(data, mode);
+				}
+				conversion.stop();
+
+				Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+				table->AddColumn(make_column("X-axis", series_view(reduced.x), COPY));
+				table->AddColumn(make_column(name.c_str(), series_view(reduced.y), COPY));
+			}
+			else {
+				Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+				table->AddColumn(make_column("X-axis", x_pos, mode));
+				table->AddColumn(make_column(name.c_str(), data, mode));
+			}
 
-			// vtkNamedColors:  A class holding colors and their names.
+			// Named colours
 			// For info see the folder with VTK_Coloursheets for different colour names. 
-			vtkSmartPointer<vtkNamedColors> colors = vtkSmartPointer<vtkNamedColors>::New();
+			const Colour_table* colors = named_colours();
 
 			// Instantiate a vtkLine object 
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
 			vtkPlot* line = chart->AddPlot(vtkChart::LINE);
 			line->SetInputData(table, 0, 1);
 			line->GetPen()->SetColorF(colors->GetColor3d(LineColour).GetData());
-			// line->SetColor(0, 255, 0, 255);
 			line->SetWidth(width);
-		}
 
+			if (zoom) {
+				chart->GetAxis(vtkAxis::BOTTOM)->AddObserver(vtkChart::UpdateRange, zoom);
+			}
+		}
 
 		/* =================================================================================================================
 		Plotting scatter plots (points) which share the same X coordinate in each dataset 
 		================================================================================================================= */
-		template<int numPoints, int numDataSets>  // Line properties are random colours and width of 1.0 
-		void Scatter_plotter(std::string(&names)[numDataSets], float(&x_pos)[numPoints], float(&data)[numDataSets][numPoints]) {
+		inline bool Scatter_plotter(const std::vector<std::string>& names, series_view x_pos, const std::vector<series_view>& data, Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
 
 			/* ----- Notes -----:
-			Input data		-> rows = dataset number, cols = points on dataset
-			vtKtable data	-> rows = points on dataset, cols = dataset
+			names			-> one per dataset
+			data			-> one series_view per dataset, each with as many points as x_pos
 			YOU HAVE TO NAME YOUR DATASETS AND YOU HAVE TO NAME THEM DIFFERENTLY
 			*/
 
+			Instrumentation::Scope instrumentation("_2D::Scatter_plotter");
+
+			const int numDataSets = static_cast<int>(data.size());
+			if (!series_size_check("Scatter_plotter", data.size(), names.size(), "names")) { return false; }
+			for (int j = 0; j < numDataSets; j++) {
+				if (!series_size_check("Scatter_plotter", x_pos.size, data[j].size, names[j].c_str())) { return false; }
+			}
+
 			// Create a table with some points in it
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
 			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
 
-			// Instantiate an array of vtkFloatArray type. (Holds line data )
-			vtkSmartPointer<vtkFloatArray> arr[numDataSets + 1];
+			// Instantiate the x-axis. Recall x axis is vtkTable col [0].
+			table->AddColumn(make_column("X-axis", x_pos, mode));
 
-			// Instantiate the x-axis (Cant use condition in allocation loop for some reason...)
-			arr[X_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[X_axis]->SetName("X-axis");
-			table->AddColumn(arr[X_axis]);
+			// One collumn per dataset (j+1 on vtkTable as x-axis was added)
+			// NAMING LINES MATTERS BECAUSE IF YOU DONT VTK WONT WORK. THEY ALSO NEED DIFFERENT NAMES. 
+			for (int j = 0; j < numDataSets; j++) {
+				table->AddColumn(make_column(names[j].c_str(), data[j], block_row_mode(mode, j)));
+			}
+			table_timer.stop();
 
-			// Allocate float array data and give names. Note numLines + 1 as you have to include x-axis. 
-			for (int j = 1; j < numDataSets + 1; j++) {
+			// Add multiple line plots, setting the colors etc
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+			vtkSmartPointer<vtkChartXY> chart = vtkSmartPointer<vtkChartXY>::New();
 
-				// Allocate float array data
-				arr[j] = vtkSmartPointer<vtkFloatArray>::New();
+			// Deterministic series colours (seed with Palette::set_default_seed)
+			Palette palette;
 
-				// NAMING LINES MATTERS BECAUSE IF YOU DONT VTK WONT WORK. THEY ALSO NEED DIFFERENT NAMES.
-				arr[j]->SetName(names[j - 1].c_str());	// j-1 to offset data (as x-axis was added)
+			// Loop over datasets and input data to vtkPlotPoints for plotting: Points -> chart -> view -> Renderwindow, Interactor
+			for (int j = 1; j < numDataSets + 1; j++) {
+
+				vtkPlot* points = chart->AddPlot(vtkChart::POINTS);
+				points->SetInputData(table, 0, j);
 
-				// Add collumn to vtkTable with vtkFloatarray memory 
-				table->AddColumn(arr[j]);
+				// Point properties
+				points->GetPen()->SetColorF(palette.next().GetData());
+				points->SetWidth(1.0);
+				dynamic_cast<vtkPlotPoints*>(points)->SetMarkerStyle(vtkPlotPoints::CIRCLE); // CIRCLE = 4 in shape enum in vtkPlotPoints class
 			}
 
-			// Set number of rows on table for number of points 
-			table->SetNumberOfRows(numPoints);
+			layout.stop();
+			Instrumentation::update_measured(chart.GetPointer());
 
-			// Set/transform raw data to vtkTable 
-			for (int i = 0; i < numDataSets; i++) {
-				for (int j = 0; j < numPoints; j++) {
-					table->SetValue(j, 0, x_pos[j]);		// Recall x axis is vtkTable col [0].
-					table->SetValue(j, i + 1, data[i][j]);	// Access data col-wise for efficiency (col0,col1,col2,col3 etc..) 
-															// i+1 to put data on correct collumns on vtkTable
-				}
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(chart, default_background, target);
 			}
 
 			// Set up the view
 			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
 			view->GetRenderer()->SetBackground(1.0, 1.0, 1.0);
+			view->GetScene()->AddItem(chart);
+
+			// Start interactor and render window
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
+			view->GetRenderWindow()->Render();
+			render_timer.stop();
+			instrumentation.finish();
+			view->GetInteractor()->Initialize();
+			view->GetInteractor()->Start();
+			return true;
+		}
+
+		/* =================================================================================================================
+		Plot N number of scatter datasets where data points have different X coordinates for each data set.
+		Each dataset gets its own vtkTable so datasets may have different numbers of points.
+		=================================================================================================================  */
+		inline bool Scatter_plotter(const std::vector<std::string>& names, const std::vector<series_view>& x_pos, const std::vector<series_view>& data, Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
+
+			/* ----- Notes -----:
+			names			-> one per dataset, or 2 * datasets (x collumn names first then dataset names, as the fixed size variant)
+			x_pos, data		-> one series_view per dataset, x_pos[j] and data[j] must be the same size
+			YOU HAVE TO NAME YOUR DATASETS AND YOU HAVE TO NAME THEM DIFFERENTLY */
+
+			Instrumentation::Scope instrumentation("_2D::Scatter_plotter");
+
+			const int numDataSets = static_cast<int>(data.size());
+			const bool namedX = (names.size() == 2 * data.size());
+			if (!series_size_check("Scatter_plotter", data.size(), x_pos.size(), "x_pos")) { return false; }
+			if (!namedX && !series_size_check("Scatter_plotter", data.size(), names.size(), "names")) { return false; }
+			for (int j = 0; j < numDataSets; j++) {
+				if (!series_size_check("Scatter_plotter", x_pos[j].size, data[j].size, "data")) { return false; }
+			}
 
 			// Add multiple line plots, setting the colors etc
 			vtkSmartPointer<vtkChartXY> chart = vtkSmartPointer<vtkChartXY>::New();
-			view->GetScene()->AddItem(chart);
 
-			// RGB array for random colours for plotting multiple lines 
-			double RGB[3];
+			// Deterministic series colours (seed with Palette::set_default_seed)
+			Palette palette;
 
-			// Instantiate a vtkPlot object with POINTS
-			vtkPlot* points = chart->AddPlot(vtkChart::POINTS);
+			// Loop over datasets and input data to vtkPlotPoints for plotting: Points -> chart -> view -> Renderwindow, Interactor
+			for (int j = 0; j < numDataSets; j++) {
 
-			// Loop over lines and input data to vtkLine for plotting: Line -> chart -> view -> Renderwindow, Interactor
-			for (int j = 1; j < numDataSets + 1; j++) {
+				const std::string& setName = namedX ? names[j + numDataSets] : names[j];
+				const std::string xName = namedX ? names[j] : "X: " + names[j];
 
-				// Add a plot for each line after first iteration. 
-				if (j > 1) {
-					points = chart->AddPlot(vtkChart::POINTS);
-				}
-				points->SetInputData(table, 0, j);
+				// Table per dataset: col 0 -> x, col 1 -> data
+				Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+				vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+				table->AddColumn(make_column(xName.c_str(), x_pos[j], block_row_mode(mode, j)));
+				table->AddColumn(make_column(setName.c_str(), data[j], block_row_mode(mode, j)));
+				table_timer.stop();
 
-				// Line properties
-				RGB[0] = std::rand() % 255;
-				RGB[1] = std::rand() % 255;
-				RGB[2] = std::rand() % 255;
-				points->SetColor(RGB[0], RGB[1], RGB[2]);
+				Instrumentation::Stage_timer plot_layout(Instrumentation::LAYOUT);
+
+				vtkPlot* points = chart->AddPlot(vtkChart::POINTS);
+				points->SetInputData(table, 0, 1);
+
+				// Point properties
+				points->GetPen()->SetColorF(palette.next().GetData());
 				points->SetWidth(1.0);
 				dynamic_cast<vtkPlotPoints*>(points)->SetMarkerStyle(vtkPlotPoints::CIRCLE); // CIRCLE = 4 in shape enum in vtkPlotPoints class
+			}
 
-				// Dynamic_cast for runtime checks on polymorphism 
-				// Polymorphism used as chart does not take vtkPlotPoints as an input (I think)
-				// e.g. setMarkerStyle not available in vtkPlot but is in vtkPlotPoints. 
+			Instrumentation::update_measured(chart.GetPointer());
+
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(chart, default_background, target);
 			}
 
-			// Start interactor and render window
+			// Set up the view
+			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
+			view->GetRenderer()->SetBackground(1.0, 1.0, 1.0);
+			view->GetScene()->AddItem(chart);
+
+			// Start interactor
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
 			view->GetRenderWindow()->Render();
+			render_timer.stop();
+			instrumentation.finish();
 			view->GetInteractor()->Initialize();
 			view->GetInteractor()->Start();
-		
+			return true;
 		}
 
+		/* =================================================================================================================
+		Single 2D scatter creator which adds the plot of a 2D scatter dataset to the inputted chart
+		================================================================================================================= */
+		inline void Scatter_plotter(vtkSmartPointer<vtkChartXY>& chart, series_view x_pos, series_view data, const std::string& name, const char* PointColour, float width, int marker, Ingestion mode = COPY) {
+
+			Instrumentation::Scope instrumentation("_2D::Scatter_plotter");
+			if (!series_size_check("Scatter_plotter", x_pos.size, data.size, name.c_str())) { return; }
+
+			// Create a table with some points in it
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+
+			// Instantiate the x-axis (Recall x axis is vtkTable col [0]) and the data for the dataset
+			table->AddColumn(make_column("X-axis", x_pos, mode));
+			table->AddColumn(make_column(name.c_str(), data, mode));
+			table_timer.stop();
+
+			// Named colours
+			// For info see the folder with VTK_Coloursheets for different colour names. 
+			const Colour_table* colors = named_colours();
+
+			// Instantiate a vtkPlotPoints object
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+			vtkPlot* points = chart->AddPlot(vtkChart::POINTS);
+			points->SetInputData(table, 0, 1);
+			points->GetPen()->SetColorF(colors->GetColor3d(PointColour).GetData());
+			points->SetWidth(width);
+			dynamic_cast<vtkPlotPoints*>(points)->SetMarkerStyle(marker);
+		}
+
+
+		/* =-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-= */
+		/* ------------------- 2D Line plotters: Stack memory variant (memory must be known at compile time) ----------------- */
+		/* =-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-= */
+
+		/* Each row of a C-array block is contiguous, so these wrap the rows as series_views and forward to the runtime sized
+		   variants above (no copy made here). TAKE_OWNERSHIP means ownership of the whole block (see as_block). */
+
+		/*=================================================================================================================
+		Plot N number of lines with data points sharing the same X coordinates for each data set.
+		=================================================================================================================== */
+		template<int numPoints, int numLines, typename X, typename T> 		// Line properties are random colours and width of 1.0 
+		void Line_plotter(std::string(&names)[numLines], X(&x_pos)[numPoints], T(&data)[numLines][numPoints], Ingestion mode = COPY, const LOD::Settings& lod = LOD::Settings(), const RenderTarget& target = RenderTarget()) {
+
+			/* ----- Notes -----:
+			Input data		-> rows = Line number, cols = points on lines
+			vtKtable data	-> rows = points on lines, cols = Line number
+			YOU HAVE TO NAME YOUR LINES AND YOU HAVE TO NAME THEM DIFFERENTLY
+			*/
+
+			std::vector<series_view> rows(numLines);
+			for (int j = 0; j < numLines; j++) {
+				rows[j] = series_view(data[j], numPoints);
+			}
+
+			// x_pos is its own allocation so takes the plain mode, the data rows share one block
+			Line_plotter(std::vector<std::string>(names, names + numLines), series_view(x_pos, numPoints), rows, as_block(mode), lod, target);
+		}
 
 
 		/* =================================================================================================================
-		Plot N number of scatter datasets where data points have different X coordinates for each data set.
-		Note: Good for automating plotting for alot of datasets from big data. (i.e. if you want to plot 100 scatter sets from data)
+		Plot N number of lines where data points have different X coordinates for each data set.
+		Note: Good for automating plotting for alot of lines from big data. (i.e. if you want to plot 100 lines from data)
 		=================================================================================================================  */
 
 		/* Function to generate generic line names for any amount of lines in a plot.
 		   - VTK requires lines to be named and to be different names!					*/
-		template<int no_of_names>
-		void ScatterNameGenerator(std::string(&names)[no_of_names]) {
+		template<int no_of_names> 
+		void LineNameGenerator(std::string(&names)[no_of_names]) {
 
 			for (int i = 0; i < no_of_names; i++) {
-				names[i] = "Scatter dataset: " + std::to_string(i);
+				names[i] = "Line: " + std::to_string(i);
 			}
 		}
 
-		template<int numPoints, int numDataSets>			// Line properties are random colours and width of 1.0 
-		void Scatter_plotter(std::string(&names)[2 * numDataSets], float(&x_pos)[numDataSets][numPoints], float(&data)[numDataSets][numPoints]) {
+		template<int numPoints, int numLines, typename X, typename T>			// Line properties are random colours and width of 1.0 
+		void Line_plotter(std::string(&names)[2 * numLines], X(&x_pos)[numLines][numPoints], T(&data)[numLines][numPoints], Ingestion mode = COPY, const LOD::Settings& lod = LOD::Settings(), const RenderTarget& target = RenderTarget()) {
 
 			/* ----- Notes -----:
 			Input data		-> rows = Line number, cols = points on lines
 			vtKtable data	-> rows = points on lines, cols = Line number
 			YOU HAVE TO NAME YOUR LINES AND YOU HAVE TO NAME THEM DIFFERENTLY */
 
-			// Create a tablefor array data
-			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
-
-			// Instantiate an array of vtkFloatArray type. (Holds line data )
-			vtkSmartPointer<vtkFloatArray> arr[2 * numDataSets];
-
-			// Allocate float array data and give names. Note numLines + 1 as you have to include x-axis. 
-			for (int j = 0; j < 2 * numDataSets; j++) {
-
-				// Allocate float array data
-				arr[j] = vtkSmartPointer<vtkFloatArray>::New();
-
-				// NAMING LINES MATTERS BECAUSE IF YOU DONT VTK WONT WORK. THEY ALSO NEED DIFFERENT NAMES. 
-				arr[j]->SetName(names[j].c_str());
-
-				// Add collumn to vtkTable with vtkFloatarray memory 
-				table->AddColumn(arr[j]);
+			std::vector<series_view> x_rows(numLines), rows(numLines);
+			for (int j = 0; j < numLines; j++) {
+				x_rows[j] = series_view(x_pos[j], numPoints);
+				rows[j] = series_view(data[j], numPoints);
 			}
 
-			// Set number of rows on table for number of points 
-			table->SetNumberOfRows(numPoints);
+			Line_plotter(std::vector<std::string>(names, names + 2 * numLines), x_rows, rows, as_block(mode), lod, target);
+		}
 
-			// Set/transform raw data to vtkTable (rows -> pts, cols -> Lines : The way VTK data works..) 
-			for (int i = 0; i < numDataSets; i++) {
-				for (int j = 0; j < numPoints; j++) {
 
-					table->SetValue(j, i, x_pos[i][j]);
-					table->SetValue(j, i + numDataSets, data[i][j]);	// Accss data col-wise for efficiency (col0,col1,col2,col3 etc..) 
-				}
-			}
+		/* =================================================================================================================
+		Plotting single lines on the same render window (Lines not together in memory (e.g. data_set_1[10], data_set_2[10]))
+		Note: Works with different X coordinates for each data set.
+		================================================================================================================= */
 
-			// Set up the view
-			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
-			view->GetRenderer()->SetBackground(1.0, 1.0, 1.0);
+		// Function to instatiate a vtkChart data structure for containing line plot data
+		/* From documentation:	"In this case the smart pointer automatically manages the reference it owns. When the smart pointer variable goes out-of-scope
+								and is no longer used, such as when a function in which it is a local variable returns, it automatically informs the object by
+								decrementing the reference count. By using the static New() method provided by the smart pointer no raw pointer ever needs to
+								hold a reference to the object, so no call to Delete() is needed."	*/
+		vtkSmartPointer<vtkChartXY> multiplot_chart_instantiation() {
 
-			// Add multiple line plots, setting the colors etc
+			// Set up chart data structure
 			vtkSmartPointer<vtkChartXY> chart = vtkSmartPointer<vtkChartXY>::New();
-			view->GetScene()->AddItem(chart);
 
-			// Instantiate a vtkPlot object with POINTS
-			vtkPlot* points = chart->AddPlot(vtkChart::POINTS);
+			return chart;
+		}
 
-			// RGB array for random colours for plotting multiple datasets
-			double RGB[3];
+		// Function to start the render window and interactor (or render headless, see RenderTarget, false if the image isn't written). 
+		bool multiplot_view_window(vtkSmartPointer<vtkChartXY>& chart, const char* BackgroundColour, bool showLegend, const RenderTarget& target = RenderTarget()) {
 
-			// Loop over lines and input data to vtkLine for plotting: Line -> chart -> view -> Renderwindow, Interactor
-			for (int j = 0; j < numDataSets; j++) {
+			Instrumentation::Scope instrumentation("_2D::multiplot_view_window");
 
-				// Add a plot for each line after first iteration. 
-				if (j > 0) {
-					points = chart->AddPlot(vtkChart::POINTS);
-				}
-				points->SetInputData(table, j, j + numDataSets);
+			// Named colours
+			// For info see the folder with VTK_Coloursheets for different colour names. 
+			const Colour_table* colors = named_colours();
 
-				// Line properties
-				RGB[0] = std::rand() % 255;
-				RGB[1] = std::rand() % 255;
-				RGB[2] = std::rand() % 255;
-				points->SetColor(RGB[0], RGB[1], RGB[2]);
-				points->SetWidth(1.0);
-				dynamic_cast<vtkPlotPoints*>(points)->SetMarkerStyle(vtkPlotPoints::CIRCLE); // CIRCLE = 4 in shape enum in vtkPlotPoints class
+			// Show legend?
+			chart->SetShowLegend(showLegend);
+			Instrumentation::update_measured(chart.GetPointer());
 
-				// Dynamic_cast for runtime checks on polymorphism 
-				// Polymorphism used as chart does not take vtkPlotPoints as an input (I think)
-				// e.g. setMarkerStyle not available in vtkPlot but is in vtkPlotPoints. 
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(chart, colors->GetColor3d(BackgroundColour).GetData(), target);
 			}
 
+			// Set up the view
+			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
+			view->GetRenderer()->SetBackground(colors->GetColor3d(BackgroundColour).GetData());	// Set the background to white
+
+
+			// Add the chart to the view
+			view->GetScene()->AddItem(chart);
+
 			// Start interactor
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
 			view->GetRenderWindow()->Render();
+			render_timer.stop();
+			instrumentation.finish();
 			view->GetInteractor()->Initialize();
 			view->GetInteractor()->Start();
+			return true;
 		}
 
-		/* =================================================================================================================
-		Plotting single lines on the same render window (Lines not together in memory (e.g. data_set_1[10], data_set_2[10]))
-		Note: Works with different X coordinates for each data set.
-		================================================================================================================= */
-
-		/* Enum containing various marker styles that can be used in a plot */
-		enum {
-			NONE,CROSS,PLUS,SQUARE,CIRCLE,DIAMOND
-		};
 
-		// Plotting single scatter plots on same render window 
-		template<int numPoints> 
-		void Scatter_plotter(vtkSmartPointer<vtkChartXY>& chart, float(&x_pos)[numPoints], float(&data)[numPoints], std::string& name, const char* PointColour, float width, int marker) {
+		// Single 2D Line creator which adds the plot of a 2D line to the inputted view
+		template<int numPoints, typename X, typename T> 
+		void Line_plotter(vtkSmartPointer<vtkChartXY>& chart, X(&x_pos)[numPoints], T(&data)[numPoints], std::string& name, const char* LineColour, float width, Ingestion mode = COPY, const LOD::Settings& lod = LOD::Settings()) {
 
 			/* ----- Notes -----:
 			Input data		-> rows = Line number, cols = points on lines
@@ -517,153 +702,95 @@ namespace W_VTK {
 			YOU HAVE TO NAME YOUR LINES AND YOU HAVE TO NAME THEM DIFFERENTLY
 			*/
 
-			// Create a table with some points in it
-			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+			Line_plotter(chart, series_view(x_pos, numPoints), series_view(data, numPoints), name, LineColour, width, mode, lod);
+		}
 
-			// Instantiate an array of vtkFloatArray type. (Holds line data )
-			vtkSmartPointer<vtkFloatArray> arr[2];
 
-			// Instantiate the x-axis (Cant use condition in allocation loop for some reason...)
-			arr[X_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[X_axis]->SetName("X-axis");
-			table->AddColumn(arr[X_axis]);
+		/* =================================================================================================================
+		Plotting scatter plots (points) which share the same X coordinate in each dataset 
+		================================================================================================================= */
+		template<int numPoints, int numDataSets, typename X, typename T>  // Line properties are random colours and width of 1.0 
+		void Scatter_plotter(std::string(&names)[numDataSets], X(&x_pos)[numPoints], T(&data)[numDataSets][numPoints], Ingestion mode = COPY, const RenderTarget& target = RenderTarget()) {
 
-			// Instantiate data for next line: 
-			// Allocate float array data and give name
-			arr[1] = vtkSmartPointer<vtkFloatArray>::New();			// Allocate float array data
-			arr[1]->SetName(name.c_str());									// Set name
-			table->AddColumn(arr[1]);								// Add collumn to vtkTable with vtkFloatarray memory 
+			/* ----- Notes -----:
+			Input data		-> rows = dataset number, cols = points on dataset
+			vtKtable data	-> rows = points on dataset, cols = dataset
+			YOU HAVE TO NAME YOUR DATASETS AND YOU HAVE TO NAME THEM DIFFERENTLY
+			*/
 
-			// Set number of rows on table for number of points 
-			table->SetNumberOfRows(numPoints);
+			std::vector<series_view> rows(numDataSets);
+			for (int j = 0; j < numDataSets; j++) {
+				rows[j] = series_view(data[j], numPoints);
+			}
 
-			// Set/transform raw data to vtkTable 
+			// x_pos is its own allocation so takes the plain mode, the data rows share one block
+			Scatter_plotter(std::vector<std::string>(names, names + numDataSets), series_view(x_pos, numPoints), rows, as_block(mode), target);
+		}
 
-			for (int i = 0; i < numPoints; i++) {
-				table->SetValue(i, 0, x_pos[i]);		// Recall x axis is vtkTable col [0].
-				table->SetValue(i, 1, data[i]);
-			}
 
 
-			// vtkNamedColors:  A class holding colors and their names.
-			// For info see the folder with VTK_Coloursheets for different colour names. 
-			vtkSmartPointer<vtkNamedColors> colors = vtkSmartPointer<vtkNamedColors>::New();
+		/* =================================================================================================================
+		Plot N number of scatter datasets where data points have different X coordinates for each data set.
+		Note: Good for automating plotting for alot of datasets from big data. (i.e. if you want to plot 100 scatter sets from data)
+		=================================================================================================================  */
 
-			// Instantiate a vtkLine object 
-			vtkPlot* points = chart->AddPlot(vtkChart::POINTS);
-			points->SetInputData(table, 0, 1);
-			points->GetPen()->SetColorF(colors->GetColor3d(PointColour).GetData());
-			points->SetWidth(width);
-			dynamic_cast<vtkPlotPoints*>(points)->SetMarkerStyle(marker);
+		/* Function to generate generic line names for any amount of lines in a plot.
+		   - VTK requires lines to be named and to be different names!					*/
+		template<int no_of_names> 
+		void ScatterNameGenerator(std::string(&names)[no_of_names]) {
+
+			for (int i = 0; i < no_of_names; i++) {
+				names[i] = "Scatter dataset: " + std::to_string(i);
+			}
 		}
 
-		/*=================================================================================================================
-		Plot single point in 2D.
-		=================================================================================================================== */
-		void Scatter_plotter(vtkSmartPointer<vtkChartXY>& chart, float x_pos, float y_pos, std::string& name, const char* PointColour, float width, int marker) {
+		template<int numPoints, int numDataSets, typename X, typename T>			// Line properties are random colours and width of 1.0 
+		void Scatter_plotter(std::string(&names)[2 * numDataSets], X(&x_pos)[numDataSets][numPoints], T(&data)[numDataSets][numPoints], Ingestion mode = COPY, const RenderTarget& target = RenderTarget()) {
 
 			/* ----- Notes -----:
 			Input data		-> rows = Line number, cols = points on lines
 			vtKtable data	-> rows = points on lines, cols = Line number
-			YOU HAVE TO NAME YOUR LINES AND YOU HAVE TO NAME THEM DIFFERENTLY
-			*/
-
-			// Create a table with some points in it
-			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+			YOU HAVE TO NAME YOUR LINES AND YOU HAVE TO NAME THEM DIFFERENTLY */
 
-			// Instantiate an array of vtkFloatArray type. (Holds line data )
-			vtkSmartPointer<vtkFloatArray> arr[2];
+			std::vector<series_view> x_rows(numDataSets), rows(numDataSets);
+			for (int j = 0; j < numDataSets; j++) {
+				x_rows[j] = series_view(x_pos[j], numPoints);
+				rows[j] = series_view(data[j], numPoints);
+			}
 
-			// Instantiate the x-axis (Cant use condition in allocation loop for some reason...)
-			arr[X_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[X_axis]->SetName("X-axis");
-			table->AddColumn(arr[X_axis]);
+			Scatter_plotter(std::vector<std::string>(names, names + 2 * numDataSets), x_rows, rows, as_block(mode), target);
+		}
 
-			// Instantiate data for next line: 
-			// Allocate float array data and give name
-			arr[1] = vtkSmartPointer<vtkFloatArray>::New();			// Allocate float array data
-			arr[1]->SetName(name.c_str());									// Set name
-			table->AddColumn(arr[1]);								// Add collumn to vtkTable with vtkFloatarray memory 
+		/* =================================================================================================================
+		Plotting single lines on the same render window (Lines not together in memory (e.g. data_set_1[10], data_set_2[10]))
+		Note: Works with different X coordinates for each data set.
+		================================================================================================================= */
 
-			// Set number of rows on table for number of points 
-			table->SetNumberOfRows(1);
+		/* Enum containing various marker styles that can be used in a plot */
+		enum {
+			NONE,CROSS,PLUS,SQUARE,CIRCLE,DIAMOND
+		};
 
-			// Set/transform raw data to vtkTable 
-			table->SetValue(0, 0, x_pos);		
-			table->SetValue(0, 1, y_pos);
-			
+		// Plotting single scatter plots on same render window 
+		template<int numPoints, typename X, typename T> 
+		void Scatter_plotter(vtkSmartPointer<vtkChartXY>& chart, X(&x_pos)[numPoints], T(&data)[numPoints], std::string& name, const char* PointColour, float width, int marker, Ingestion mode = COPY) {
 
-			// vtkNamedColors:  A class holding colors and their names.
-			// For info see the folder with VTK_Coloursheets for different colour names. 
-			vtkSmartPointer<vtkNamedColors> colors = vtkSmartPointer<vtkNamedColors>::New();
+			/* ----- Notes -----:
+			Input data		-> rows = Line number, cols = points on lines
+			vtKtable data	-> rows = points on lines, cols = Line number
+			YOU HAVE TO NAME YOUR LINES AND YOU HAVE TO NAME THEM DIFFERENTLY
+			*/
 
-			// Instantiate a vtkLine object 
-			vtkPlot* points = chart->AddPlot(vtkChart::POINTS);
-			points->SetInputData(table, 0, 1);
-			points->GetPen()->SetColorF(colors->GetColor3d(PointColour).GetData());
-			points->SetWidth(width);
-			dynamic_cast<vtkPlotPoints*>(points)->SetMarkerStyle(marker);
+			Scatter_plotter(chart, series_view(x_pos, numPoints), series_view(data, numPoints), name, PointColour, width, marker, mode);
 		}
 
-		//	// Dynamic memory variant(std::vector) 
-		//	void _2DLine_plotter(const int numPoints, float inc, std::vector<float>& x_pos, std::vector<float>& data_1, std::vector<float>& data_2) {
-		//
-		//
-		//		// Create a table with some points in it
-		//		vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
-		//
-		//		vtkSmartPointer<vtkFloatArray> arrX = vtkSmartPointer<vtkFloatArray>::New();
-		//		arrX->SetName("X Axis");
-		//		table->AddColumn(arrX);
-		//
-		//		vtkSmartPointer<vtkFloatArray> arrC = vtkSmartPointer<vtkFloatArray>::New();
-		//		arrC->SetName("Cosine");
-		//		table->AddColumn(arrC);
-		//
-		//		vtkSmartPointer<vtkFloatArray> arrS = vtkSmartPointer<vtkFloatArray>::New();
-		//		arrS->SetName("Sine");
-		//		table->AddColumn(arrS);
-		//		table->SetNumberOfRows(numPoints);
-		//
-		//		// Transform raw data to vtkTable 
-		//		for (int i = 0; i < numPoints; i++) {
-		//			table->SetValue(i, 0, x_pos[i]);
-		//			table->SetValue(i, 1, data_1[i]);
-		//			table->SetValue(i, 2, data_2[i]);
-		//		}
-		//
-		//		// Set up the view
-		//		vtkSmartPointer<vtkContextView> view =
-		//			vtkSmartPointer<vtkContextView>::New();
-		//		view->GetRenderer()->SetBackground(1.0, 1.0, 1.0);
-		//
-		//		// Add multiple line plots, setting the colors etc
-		//		vtkSmartPointer<vtkChartXY> chart =
-		//			vtkSmartPointer<vtkChartXY>::New();
-		//		view->GetScene()->AddItem(chart);
-		//		vtkPlot* line = chart->AddPlot(vtkChart::LINE);
-		//		line->SetInputData(table, 0, 1);
-		//		line->SetColor(0, 255, 0, 255);
-		//		line->SetWidth(1.0);
-		//		line = chart->AddPlot(vtkChart::LINE);
-		//		line->SetInputData(table, 0, 2);
-		//		line->SetColor(255, 0, 0, 255);
-		//		line->SetWidth(5.0);
-		//
-		//		// For dotted line, the line type can be from 2 to 5 for different dash/dot
-		//		// patterns (see enum in vtkPen containing DASH_LINE, value 2):
-		//#ifndef WIN32
-		//		line->GetPen()->SetLineType(vtkPen::DASH_LINE);
-		//#endif
-		//		// (ifdef-ed out on Windows because DASH_LINE does not work on Windows
-		//		//  machines with built-in Intel HD graphics card...)
-		//
-		//		//view->GetRenderWindow()->SetMultiSamples(0);
-		//
-		//		// Start interactor
-		//		view->GetRenderWindow()->Render();
-		//		view->GetInteractor()->Initialize();
-		//		view->GetInteractor()->Start();
-//	}
+		/*=================================================================================================================
+		Plot single point in 2D.
+		=================================================================================================================== */
+		void Scatter_plotter(vtkSmartPointer<vtkChartXY>& chart, float x_pos, float y_pos, std::string& name, const char* PointColour, float width, int marker) {
+
+			// Single row, always copied
+			Scatter_plotter(chart, series_view(&x_pos, 1), series_view(&y_pos, 1), name, PointColour, width, marker, COPY);
+		}
 	}
 }
@@ -2,12 +2,15 @@
  -------------------------- 3D Line plotter wrapper for the VTK library -----------------------------
  ==================================================================================================*/
 
+#pragma once
+
 // Include library interface files
 #include <vtkNew.h>
 #include <vtkSmartPointer.h>
 #include <vtkChartXYZ.h>
 #include <vtkPen.h>
 #include <vtkPlotLine3D.h>
+#include <vtkPlotPoints3D.h>
 #include <vtkAxis.h>
 #include <vtkNamedColors.h>
 #include <vtkRenderWindow.h>
@@ -23,6 +26,12 @@
 // External modules 
 # include <iostream>
 
+// Wrapper modules 
+#include "VTK_columns.h"
+#include "VTK_output.h"
+#include "VTK_colours.h"
+#include "VTK_instrumentation.h"
+
 namespace W_VTK {
 	namespace _3D {
 		/* Enum for code clarity */
@@ -30,51 +39,57 @@ namespace W_VTK {
 			X_axis, Y_axis, Z_axis, spatial_dimensions
 		};
 
+		/* ----- Notes -----:
+		Each plotter has a runtime sized variant taking one series_view per axis (std::vector, std::span, pointer + length or
+		strided pointer e.g. for interleaved x,y,z) followed by a static memory variant taking data[spatial_dimensions][numPoints]
+		which forwards to it without copying. Values may be float, double, int32, int16 or uint8: each axis collumn is the VTK
+		array of the data's own type, so nothing is converted to float first.
+		Standalone runtime variants BORROW contiguous data by default: it must live until the window is closed. Chart variants
+		COPY by default as the chart outlives the call, pass BORROW for data that lives until multiplot_view_window returns.
+		Standalone plotters and multiplot_view_window take an optional RenderTarget last: the default opens the interactive
+		window as before, RenderTarget::Png / RenderTarget::Rgba render headless with no view or interactor (see VTK_output.h).
+		The runtime standalone plotters return false when the data is rejected (see std::cerr) or the headless image isn't
+		written, multiplot_view_window when its headless image isn't written. */
+
+		/* Runtime sizes can't be checked by the compiler so check the axes line up before VTK sees the data. */
+		inline bool axis_size_check(const series_view& x, const series_view& y, const series_view& z) {
+
+			if (x.size != y.size || x.size != z.size) {
+				std::cerr << "W_VTK::_3D: X, Y and Z have different numbers of points (" << x.size << ", " << y.size << ", " << z.size << ")\n";
+				return false;
+			}
+			return true;
+		}
+
 		/* =-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-= */
-		/* ------------------- 3D Line plotters: Static memory variant (memory must be known at compile time) ---------------- */
+		/* ----------------- 3D Line plotters: Runtime sized + Static memory variant (memory known at compile time) ---------- */
 		/* =-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-= */
 
 		/*=================================================================================================================
 		Plot single line in 3D.
 		=================================================================================================================== */
-		template <int numPoints>
-		void Line_plotter(float(&data)[spatial_dimensions][numPoints], const char* LineColourName, const char* BackgroundColour, float width) {
+		inline bool Line_plotter(series_view x, series_view y, series_view z, const char* LineColourName, const char* BackgroundColour, float width, Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
 
-			// vtkNamedColors:  A class holding colors and their names.
+			Instrumentation::Scope instrumentation("_3D::Line_plotter");
+			if (!axis_size_check(x, y, z)) { return false; }
+
+			// Named colours
 			// For info see the folder with VTK_Coloursheets for different colour names. 
-			vtkSmartPointer<vtkNamedColors> colors = vtkSmartPointer<vtkNamedColors>::New();
+			const Colour_table* colors = named_colours();
 
 			// Create the data.
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
 			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
 
-			vtkSmartPointer<vtkFloatArray> arr[spatial_dimensions];	//	3- Dimensions X,Y,Z 
-
-			// Allocate float array data for VTK data structures, name and add to vtkTable. 
-			arr[X_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[X_axis]->SetName("X");
-			table->AddColumn(arr[0]);
-
-			arr[Y_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[Y_axis]->SetName("Y");
-			table->AddColumn(arr[1]);
-
-			arr[Z_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[Z_axis]->SetName("Z");
-			table->AddColumn(arr[2]);
+			// Each axis goes straight onto a vtkTable collumn (no per-point SetValue). 
+			// X -> col 0; Y -> col 1; Z -> col 2
+			table->AddColumn(make_column("X", x, block_row_mode(mode, X_axis)));
+			table->AddColumn(make_column("Y", y, block_row_mode(mode, Y_axis)));
+			table->AddColumn(make_column("Z", z, block_row_mode(mode, Z_axis)));
+			table_timer.stop();
 
-			// Set number of rows on table for number of points 
-			table->SetNumberOfRows(numPoints);
-
-			// Set/transform raw data to vtk data structure
-			for (unsigned int i = 0; i < spatial_dimensions; i++) {	// Dimensions loop 
-				for (unsigned int j = 0; j < numPoints; j++) {		// Discretization loop (points) 
-					table->SetValue(j, i, data[i][j]);				// X -> j = 0; Y -> j = 1; Z -> j = 2
-				}
-			}
-
-			// Set up a 3D scene and add an XYZ chart to it.
-			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
-			view->GetRenderWindow()->SetSize(640, 480);
+			// Plots are set up and the chart updated under LAYOUT
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
 
 			// Set up a chart to contrain the plots. 
 			vtkSmartPointer<vtkChartXYZ> chart = vtkSmartPointer<vtkChartXYZ>::New();
@@ -117,14 +132,37 @@ namespace W_VTK {
 			//std::cout << "Z axis visibility bool in chart: " << chart->GetAxis(2)->GetAxisVisible() << "\n";
 			//std::cin.get();
 
+			layout.stop();
+			Instrumentation::update_measured(chart.GetPointer());
+
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(chart, colors->GetColor3d(BackgroundColour).GetData(), target);
+			}
+
+			// Set up a 3D scene and add an XYZ chart to it.
+			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
+			view->GetRenderWindow()->SetSize(640, 480);
+
 			// Apply chart data structure to scene
 			view->GetScene()->AddItem(chart);
 
 			// Render the scene
 			view->GetRenderer()->SetBackground(colors->GetColor3d(BackgroundColour).GetData());
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
 			view->GetRenderWindow()->Render();
+			render_timer.stop();
+			instrumentation.finish();
 			view->GetInteractor()->Initialize();
 			view->GetInteractor()->Start();
+			return true;
+		}
+
+		template <int numPoints, typename T>
+		void Line_plotter(T(&data)[spatial_dimensions][numPoints], const char* LineColourName, const char* BackgroundColour, float width, Ingestion mode = COPY, const RenderTarget& target = RenderTarget()) {
+
+			// Axis rows of the C-array block are contiguous, so forward them to the runtime sized variant as views 
+			Line_plotter(series_view(data[X_axis], numPoints), series_view(data[Y_axis], numPoints), series_view(data[Z_axis], numPoints), LineColourName, BackgroundColour, width, as_block(mode), target);
 		}
 
 
@@ -132,40 +170,28 @@ namespace W_VTK {
 		Plotting single 3D lines on the same render window (Lines not together in memory (e.g. data_set_1[3][10], data_set_2[3][10]))
 		Note: Works with different X coordinates for each data set.
 		================================================================================================================= */
-		template <int numPoints>
-		void Line_plotter(vtkSmartPointer<vtkChartXYZ>& chart, float(&data)[spatial_dimensions][numPoints], const char* LineColourName, float width) {
+		inline void Line_plotter(vtkSmartPointer<vtkChartXYZ>& chart, series_view x, series_view y, series_view z, const char* LineColourName, float width, Ingestion mode = COPY) {
 
-			// vtkNamedColors:  A class holding colors and their names.
+			Instrumentation::Scope instrumentation("_3D::Line_plotter");
+			if (!axis_size_check(x, y, z)) { return; }
+
+			// Named colours
 			// For info see the folder with VTK_Coloursheets for different colour names. 
-			vtkSmartPointer<vtkNamedColors> colors = vtkSmartPointer<vtkNamedColors>::New();
+			const Colour_table* colors = named_colours();
 
 			// Create the data.
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
 			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
 
-			vtkSmartPointer<vtkFloatArray> arr[spatial_dimensions];	//	3- Dimensions X,Y,Z 
-
-			// Allocate float array data for VTK data structures, name and add to vtkTable. 
-			arr[X_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[X_axis]->SetName("X");
-			table->AddColumn(arr[0]);
+			// Each axis goes straight onto a vtkTable collumn (no per-point SetValue). 
+			// X -> col 0; Y -> col 1; Z -> col 2
+			table->AddColumn(make_column("X", x, block_row_mode(mode, X_axis)));
+			table->AddColumn(make_column("Y", y, block_row_mode(mode, Y_axis)));
+			table->AddColumn(make_column("Z", z, block_row_mode(mode, Z_axis)));
+			table_timer.stop();
 
-			arr[Y_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[Y_axis]->SetName("Y");
-			table->AddColumn(arr[1]);
-
-			arr[Z_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[Z_axis]->SetName("Z");
-			table->AddColumn(arr[2]);
-
-			// Set number of rows on table for number of points 
-			table->SetNumberOfRows(numPoints);
-
-			// Set/transform raw data to vtk data structure
-			for (unsigned int i = 0; i < spatial_dimensions; i++) {	// Dimensions loop 
-				for (unsigned int j = 0; j < numPoints; j++) {		// Discretization loop (points) 
-					table->SetValue(j, i, data[i][j]);				// X -> j = 0; Y -> j = 1; Z -> j = 2
-				}
-			}
+			// Plots are set up and the chart updated under LAYOUT
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
 
 			// Create a 3D line plot using vtkPlotLine3D and input vtkTable data
 			// Create multiple of these for multiple 3D lines !! =================
@@ -198,6 +224,12 @@ namespace W_VTK {
 			//std::cin.get();
 		}
 
+		template <int numPoints, typename T>
+		void Line_plotter(vtkSmartPointer<vtkChartXYZ>& chart, T(&data)[spatial_dimensions][numPoints], const char* LineColourName, float width, Ingestion mode = COPY) {
+
+			Line_plotter(chart, series_view(data[X_axis], numPoints), series_view(data[Y_axis], numPoints), series_view(data[Z_axis], numPoints), LineColourName, width, as_block(mode));
+		}
+
 		
 		// Function to instatiate a vtkChartXYZ data structure for containing line plot data
 		vtkSmartPointer<vtkChartXYZ> multiplot_chart_instantiation() {
@@ -215,12 +247,20 @@ namespace W_VTK {
 			return chart;
 		}
 
-		// Function to start the render window and interactor. 
-		void multiplot_view_window(vtkSmartPointer<vtkChartXYZ>& chart, const char* BackgroundColour) {
+		// Function to start the render window and interactor (or render headless, see RenderTarget, false if the image isn't written). 
+		bool multiplot_view_window(vtkSmartPointer<vtkChartXYZ>& chart, const char* BackgroundColour, const RenderTarget& target = RenderTarget()) {
 
-			// vtkNamedColors:  A class holding colors and their names.
+			Instrumentation::Scope instrumentation("_3D::multiplot_view_window");
+
+			// Named colours
 			// For info see the folder with VTK_Coloursheets for different colour names. 
-			vtkSmartPointer<vtkNamedColors> colors = vtkSmartPointer<vtkNamedColors>::New();
+			const Colour_table* colors = named_colours();
+			Instrumentation::update_measured(chart.GetPointer());
+
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(chart, colors->GetColor3d(BackgroundColour).GetData(), target);
+			}
 
 			// Set up a 3D scene and add an XYZ chart to it.
 			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
@@ -231,59 +271,47 @@ namespace W_VTK {
 
 			// Render the scene
 			view->GetRenderer()->SetBackground(colors->GetColor3d(BackgroundColour).GetData());
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
 			view->GetRenderWindow()->Render();
+			render_timer.stop();
+			instrumentation.finish();
 			view->GetInteractor()->Initialize();
 			view->GetInteractor()->Start();
+			return true;
 		}
 
 		// Note, no option to show legend or name the lines for vtkChartXYZ (no member functions like in vtkChartXY)
 
 
 		/* =-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-= */
-		/* ----------------- 3D scatter plotters: Static memory variant (memory must be known at compile time) ---------------- */
+		/* --------------- 3D scatter plotters: Runtime sized + Static memory variant (memory known at compile time) ---------- */
 		/* =-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-= */
 
 		/*=================================================================================================================
 		Plot single scatter plot in 3D.
 		=================================================================================================================== */
-		template <int numPoints>
-		void Scatter_plotter(float(&data)[spatial_dimensions][numPoints], const char* PointColourName, const char* BackgroundColour, float width ) {
+		inline bool Scatter_plotter(series_view x, series_view y, series_view z, const char* PointColourName, const char* BackgroundColour, float width, Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
+
+			Instrumentation::Scope instrumentation("_3D::Scatter_plotter");
+			if (!axis_size_check(x, y, z)) { return false; }
 
-			// vtkNamedColors:  A class holding colors and their names.
+			// Named colours
 			// For info see the folder with VTK_Coloursheets for different colour names. 
-			vtkSmartPointer<vtkNamedColors> colors = vtkSmartPointer<vtkNamedColors>::New();
+			const Colour_table* colors = named_colours();
 
 			// Create the data.
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
 			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
 
-			vtkSmartPointer<vtkFloatArray> arr[spatial_dimensions];	//	3- Dimensions X,Y,Z 
-
-			// Allocate float array data for VTK data structures, name and add to vtkTable. 
-			arr[X_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[X_axis]->SetName("X");
-			table->AddColumn(arr[0]);
-
-			arr[Y_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[Y_axis]->SetName("Y");
-			table->AddColumn(arr[1]);
-
-			arr[Z_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[Z_axis]->SetName("Z");
-			table->AddColumn(arr[2]);
+			// Each axis goes straight onto a vtkTable collumn (no per-point SetValue). 
+			// X -> col 0; Y -> col 1; Z -> col 2
+			table->AddColumn(make_column("X", x, block_row_mode(mode, X_axis)));
+			table->AddColumn(make_column("Y", y, block_row_mode(mode, Y_axis)));
+			table->AddColumn(make_column("Z", z, block_row_mode(mode, Z_axis)));
+			table_timer.stop();
 
-			// Set number of rows on table for number of points 
-			table->SetNumberOfRows(numPoints);
-
-			// Set/transform raw data to vtk data structure
-			for (unsigned int i = 0; i < spatial_dimensions; i++) {	// Dimensions loop 
-				for (unsigned int j = 0; j < numPoints; j++) {		// Discretization loop (points) 
-					table->SetValue(j, i, data[i][j]);				// X -> j = 0; Y -> j = 1; Z -> j = 2
-				}
-			}
-
-			// Set up a 3D scene and add an XYZ chart to it.
-			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
-			view->GetRenderWindow()->SetSize(640, 480);
+			// Plots are set up and the chart updated under LAYOUT
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
 
 			// Set up a chart to contrain the plots. 
 			vtkSmartPointer<vtkChartXYZ> chart = vtkSmartPointer<vtkChartXYZ>::New();
@@ -326,54 +354,64 @@ namespace W_VTK {
 			//std::cout << "Z axis visibility bool in chart: " << chart->GetAxis(2)->GetAxisVisible() << "\n";
 			//std::cin.get();
 
+			layout.stop();
+			Instrumentation::update_measured(chart.GetPointer());
+
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(chart, colors->GetColor3d(BackgroundColour).GetData(), target);
+			}
+
+			// Set up a 3D scene and add an XYZ chart to it.
+			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
+			view->GetRenderWindow()->SetSize(640, 480);
+
 			// Apply chart data structure to scene
 			view->GetScene()->AddItem(chart);
 
 			// Render the scene
 			view->GetRenderer()->SetBackground(colors->GetColor3d(BackgroundColour).GetData());
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
 			view->GetRenderWindow()->Render();
+			render_timer.stop();
+			instrumentation.finish();
 			view->GetInteractor()->Initialize();
 			view->GetInteractor()->Start();
+			return true;
+		}
+
+		template <int numPoints, typename T>
+		void Scatter_plotter(T(&data)[spatial_dimensions][numPoints], const char* PointColourName, const char* BackgroundColour, float width, Ingestion mode = COPY, const RenderTarget& target = RenderTarget()) {
+
+			Scatter_plotter(series_view(data[X_axis], numPoints), series_view(data[Y_axis], numPoints), series_view(data[Z_axis], numPoints), PointColourName, BackgroundColour, width, as_block(mode), target);
 		}
 
 		/* =================================================================================================================
 		Plotting single 3D scatter plot on the same render window (Lines not together in memory (e.g. data_set_1[3][10], data_set_2[3][10]))
 		Note: Works with different X coordinates for each data set.
 		================================================================================================================= */
-		template <int numPoints>
-		void Scatter_plotter(vtkSmartPointer<vtkChartXYZ>& chart, float(&data)[spatial_dimensions][numPoints], const char* PointColourName, float width) {
+		inline void Scatter_plotter(vtkSmartPointer<vtkChartXYZ>& chart, series_view x, series_view y, series_view z, const char* PointColourName, float width, Ingestion mode = COPY) {
 
-			// vtkNamedColors:  A class holding colors and their names.
+			Instrumentation::Scope instrumentation("_3D::Scatter_plotter");
+			if (!axis_size_check(x, y, z)) { return; }
+
+			// Named colours
 			// For info see the folder with VTK_Coloursheets for different colour names. 
-			vtkSmartPointer<vtkNamedColors> colors = vtkSmartPointer<vtkNamedColors>::New();
+			const Colour_table* colors = named_colours();
 
 			// Create the data.
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
 			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
 
-			vtkSmartPointer<vtkFloatArray> arr[spatial_dimensions];	//	3- Dimensions X,Y,Z 
-
-			// Allocate float array data for VTK data structures, name and add to vtkTable. 
-			arr[X_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[X_axis]->SetName("X");
-			table->AddColumn(arr[0]);
+			// Each axis goes straight onto a vtkTable collumn (no per-point SetValue). 
+			// X -> col 0; Y -> col 1; Z -> col 2
+			table->AddColumn(make_column("X", x, block_row_mode(mode, X_axis)));
+			table->AddColumn(make_column("Y", y, block_row_mode(mode, Y_axis)));
+			table->AddColumn(make_column("Z", z, block_row_mode(mode, Z_axis)));
+			table_timer.stop();
 
-			arr[Y_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[Y_axis]->SetName("Y");
-			table->AddColumn(arr[1]);
-
-			arr[Z_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[Z_axis]->SetName("Z");
-			table->AddColumn(arr[2]);
-
-			// Set number of rows on table for number of points 
-			table->SetNumberOfRows(numPoints);
-
-			// Set/transform raw data to vtk data structure
-			for (unsigned int i = 0; i < spatial_dimensions; i++) {	// Dimensions loop 
-				for (unsigned int j = 0; j < numPoints; j++) {		// Discretization loop (points) 
-					table->SetValue(j, i, data[i][j]);				// X -> j = 0; Y -> j = 1; Z -> j = 2
-				}
-			}
+			// Plots are set up and the chart updated under LAYOUT
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
 
 			// Create a 3D line plot using vtkPlotLine3D and input vtkTable data
 			// Create multiple of these for multiple 3D lines !! =================
@@ -406,6 +444,12 @@ namespace W_VTK {
 			//std::cin.get();
 		}
 
+		template <int numPoints, typename T>
+		void Scatter_plotter(vtkSmartPointer<vtkChartXYZ>& chart, T(&data)[spatial_dimensions][numPoints], const char* PointColourName, float width, Ingestion mode = COPY) {
+
+			Scatter_plotter(chart, series_view(data[X_axis], numPoints), series_view(data[Y_axis], numPoints), series_view(data[Z_axis], numPoints), PointColourName, width, as_block(mode));
+		}
+
 
 		/*=================================================================================================================
 		Plot single point in 3D.
@@ -413,35 +457,24 @@ namespace W_VTK {
 
 		void Scatter_plotter(vtkSmartPointer<vtkChartXYZ>& chart, float(&data)[spatial_dimensions], const char* PointColourName, float width) {
 
-			// vtkNamedColors:  A class holding colors and their names.
+			Instrumentation::Scope instrumentation("_3D::Scatter_plotter");
+
+			// Named colours
 			// For info see the folder with VTK_Coloursheets for different colour names. 
-			vtkSmartPointer<vtkNamedColors> colors = vtkSmartPointer<vtkNamedColors>::New();
+			const Colour_table* colors = named_colours();
 
 			// Create the data.
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
 			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
 
-			vtkSmartPointer<vtkFloatArray> arr[spatial_dimensions];	//	3- Dimensions X,Y,Z 
-
-			// Allocate float array data for VTK data structures, name and add to vtkTable. 
-			arr[X_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[X_axis]->SetName("X");
-			table->AddColumn(arr[0]);
+			// Single row per axis, always copied. X -> col 0; Y -> col 1; Z -> col 2
+			table->AddColumn(make_column("X", &data[X_axis], 1, COPY));
+			table->AddColumn(make_column("Y", &data[Y_axis], 1, COPY));
+			table->AddColumn(make_column("Z", &data[Z_axis], 1, COPY));
+			table_timer.stop();
 
-			arr[Y_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[Y_axis]->SetName("Y");
-			table->AddColumn(arr[1]);
-
-			arr[Z_axis] = vtkSmartPointer<vtkFloatArray>::New();
-			arr[Z_axis]->SetName("Z");
-			table->AddColumn(arr[2]);
-
-			// Set number of rows on table for number of points 
-			table->SetNumberOfRows(1);
-
-			// Set/transform raw data to vtk data structure
-			for (unsigned int i = 0; i < spatial_dimensions; i++) {	// Dimensions loop 
-				table->SetValue(0, i, data[i]);				
-			}
+			// Plots are set up and the chart updated under LAYOUT
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
 
 			// Create a 3D line plot using vtkPlotLine3D and input vtkTable data
 			// Create multiple of these for multiple 3D lines !! =================
@@ -0,0 +1,359 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------ Animation export: frames prepared on workers while the figure renders the last one ----
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkPNGWriter.h>
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_output.h"
+#include "VTK_parallel.h"
+#include "VTK_figure.h"
+
+/* External modules */
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	namespace Animation {
+
+		/* ----- Notes -----:
+		Looping over timesteps and re-plotting does conversion, table build and render strictly one after the other.
+		export_frames runs a Figure (2D or 3D, made with a RenderTarget::Rgba target) through a frame sequence as a pipeline:
+			workers			-> prepare(frame, data): load / compute / decimate the data of the next frames (depth - 1 ahead)
+			calling thread	-> upload(figure, data) + figure.render(): the only VTK rendering, on the thread that made the figure
+			writers			-> numbered PNGs (encoded in parallel) or one raw RGBA stream (in order)
+		so once the pipeline is full each frame costs about the slowest of the three, normally the render:
+			std::vector<unsigned char> pixels;
+			RenderTarget target = RenderTarget::Rgba(pixels, 1280, 720);
+			_3D::Figure figure("White", target);
+			figure.add_line(x, y, z);					// Series 0 (its first frame's data)
+			Animation::export_frames(figure, target, Animation::Settings::Png("frames/step_"), steps,
+				[&](size_t step, Animation::Frame& data) {
+					data.columns.resize(3);				// x, y, z of series 0 (see upload_frame)
+					load_step(step, data.columns);
+					return true;						// false stops the export
+				});
+		The figure borrows a frame's collumns until the next frame replaces them, and their buffers are reused depth frames
+		later, so steady state frames allocate nothing. Raw streams are RGBA rows top to bottom, e.g. for
+			ffmpeg -f rawvideo -pix_fmt rgba -s 1280x720 -r 30 -i movie.rgba movie.mp4 */
+
+		/* Where the frames go */
+		enum Output {
+			PNG_SEQUENCE, RAW_VIDEO
+		};
+
+		struct Settings {
+
+			Output output;
+			std::string path;		// PNG_SEQUENCE: prefix, frame f -> path + zero padded f + ".png". RAW_VIDEO: the file ("-" -> stdout)
+			int digits;				// Zero padding of the PNG frame numbers
+			size_t depth;			// Frames in flight (>= 2): depth - 1 are prepared ahead of the one rendering
+			unsigned threads;		// Prepare workers (0 -> depth - 1, capped at the hardware threads)
+			unsigned writers;		// PNG encoders (raw streams always use one, the frames must stay in order)
+
+			Settings() : output(PNG_SEQUENCE), digits(5), depth(3), threads(0), writers(2) {}
+
+			static Settings Png(const std::string& prefix, unsigned writers = 2) {
+				Settings settings;
+				settings.path = prefix;
+				settings.writers = writers;
+				return settings;
+			}
+
+			static Settings Raw(const std::string& path) {
+				Settings settings;
+				settings.output = RAW_VIDEO;
+				settings.path = path;
+				settings.writers = 1;
+				return settings;
+			}
+		};
+
+		/* One frame's data as prepare leaves it for upload. The vectors are kept between frames (clear / resize, don't swap
+		   them out) so their memory is reused. */
+		struct Frame {
+			size_t index;
+			std::vector<std::vector<float>> columns;
+		};
+
+		/* Where the time went (seconds summed per stage, so prepare and write can exceed the wall time) */
+		struct Export_stats {
+
+			size_t frames;				// Frames written
+			double seconds;				// Wall time
+			double prepare_seconds;
+			double render_seconds;		// Upload + render + read back, on the calling thread
+			double write_seconds;
+
+			Export_stats() : frames(0), seconds(0.0), prepare_seconds(0.0), render_seconds(0.0), write_seconds(0.0) {}
+
+			/* How close the export came to the render stage alone (1 -> nothing else on the critical path) */
+			double render_share() const { return (seconds > 0.0) ? render_seconds / seconds : 0.0; }
+		};
+
+		/* Default upload: series i of a 2D figure gets columns 2i (x), 2i + 1 (y), borrowed */
+		inline bool upload_frame(_2D::Figure& figure, const Frame& data) {
+
+			for (size_t i = 0; 2 * i + 1 < data.columns.size(); i++) {
+				if (!figure.set_series(i, data.columns[2 * i], data.columns[2 * i + 1], BORROW)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/* Default upload: series i of a 3D figure gets columns 3i (x), 3i + 1 (y), 3i + 2 (z), borrowed */
+		inline bool upload_frame(_3D::Figure& figure, const Frame& data) {
+
+			for (size_t i = 0; 3 * i + 2 < data.columns.size(); i++) {
+				if (!figure.set_series(i, data.columns[3 * i], data.columns[3 * i + 1], data.columns[3 * i + 2], BORROW)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/* Writes finished frames: PNG encoders (one image + writer each, reused) or the raw stream */
+		class Frame_writer {
+
+		public:
+
+			Frame_writer(const Settings& settings, int width, int height) : settings(settings), width(width), height(height), stream(nullptr), flipped(static_cast<size_t>(width) * height * 4) {
+
+				if (settings.output == RAW_VIDEO) {
+					stream = (settings.path == "-") ? stdout : std::fopen(settings.path.c_str(), "wb");
+					if (!stream) {
+						std::cerr << "W_VTK::Animation: could not open " << settings.path << "\n";
+					}
+				}
+			}
+
+			~Frame_writer() {
+				if (stream && stream != stdout) {
+					std::fclose(stream);
+				}
+			}
+
+			bool valid() const { return settings.output != RAW_VIDEO || stream != nullptr; }
+
+			/* RGBA rows bottom to top (as read back from OpenGL) */
+			bool write(size_t frame, unsigned char* rgba) {
+
+				if (settings.output == RAW_VIDEO) {
+					const size_t row = static_cast<size_t>(width) * 4;
+					for (int r = 0; r < height; r++) {
+						std::memcpy(&flipped[row * r], rgba + row * (height - 1 - r), row);
+					}
+					return std::fwrite(flipped.data(), 1, flipped.size(), stream) == flipped.size();
+				}
+
+				if (!image) {
+					image = vtkSmartPointer<vtkImageData>::New();
+					image->SetDimensions(width, height, 1);
+					pixels = vtkSmartPointer<vtkUnsignedCharArray>::New();
+					pixels->SetNumberOfComponents(4);
+					png = vtkSmartPointer<vtkPNGWriter>::New();
+				}
+
+				// vtkImageData rows run bottom to top too, so the buffer is wrapped as it is
+				pixels->SetArray(rgba, static_cast<vtkIdType>(width) * height * 4, 1);
+				image->GetPointData()->SetScalars(pixels);
+				image->Modified();
+
+				std::string number = std::to_string(frame);
+				if (number.size() < static_cast<size_t>(settings.digits)) {
+					number.insert(0, settings.digits - number.size(), '0');
+				}
+				const std::string path = settings.path + number + ".png";
+				png->SetFileName(path.c_str());
+				png->SetInputData(image);
+				png->Write();
+				if (png->GetErrorCode() != 0) {
+					std::cerr << "W_VTK::Animation: could not write " << path << "\n";
+					return false;
+				}
+				return true;
+			}
+
+		private:
+
+			Frame_writer(const Frame_writer&) = delete;
+			Frame_writer& operator=(const Frame_writer&) = delete;
+
+			Settings settings;
+			int width, height;
+			FILE* stream;
+			std::vector<unsigned char> flipped;
+			vtkSmartPointer<vtkImageData> image;
+			vtkSmartPointer<vtkUnsignedCharArray> pixels;
+			vtkSmartPointer<vtkPNGWriter> png;
+		};
+
+		/* =================================================================================================================
+		Export frames [0, frames) of figure. target is the RGBA target the figure was made with (its buffer is read after
+		each render). prepare runs on the workers, upload (default upload_frame) and the rendering on the calling thread.
+		Stops at the first frame prepare, upload or a write fails on (the frames before it are still written).
+		================================================================================================================= */
+		template<typename Figure>
+		Export_stats export_frames(Figure& figure, const RenderTarget& target, const Settings& settings, size_t frames,
+			std::function<bool(size_t, Frame&)> prepare, std::function<bool(Figure&, const Frame&)> upload = nullptr) {
+
+			typedef std::chrono::steady_clock clock;
+			const clock::time_point start = clock::now();
+			Export_stats stats;
+
+			if (target.kind != RenderTarget::RGBA || target.rgba == nullptr) {
+				std::cerr << "W_VTK::Animation: the figure needs a RenderTarget::Rgba target\n";
+				return stats;
+			}
+			if (!upload) {
+				upload = [](Figure& f, const Frame& data) { return upload_frame(f, data); };
+			}
+
+			const size_t depth = (settings.depth < 2) ? 2 : settings.depth;
+			const unsigned preparers = worker_count(settings.threads, depth - 1);
+			const unsigned writers = (settings.output == RAW_VIDEO) ? 1 : worker_count(settings.writers, depth);
+			const size_t image_bytes = static_cast<size_t>(target.width) * target.height * 4;
+
+			// Slot f % depth holds frame f's data and image. Stamps are frame + 1 of what the slot holds (0 -> nothing yet).
+			std::vector<Frame> data(depth);
+			std::vector<std::vector<unsigned char>> images(depth, std::vector<unsigned char>(image_bytes));
+			std::vector<size_t> prepared(depth, 0), rendered(depth, 0), written(depth, 0);
+			size_t frames_rendered = 0, next_prepare = 0, next_write = 0;
+			size_t failed_at = frames;		// First frame that failed (frames before it are still finished)
+
+			std::mutex lock;
+			std::condition_variable changed;
+			double prepare_seconds = 0.0, write_seconds = 0.0;
+
+			// A frame's data may be refilled once the frame after it is uploaded (the figure borrows it until then)
+			auto prepare_worker = [&]() {
+				for (;;) {
+					std::unique_lock<std::mutex> guard(lock);
+					const size_t f = next_prepare++;
+					changed.wait(guard, [&] { return f >= failed_at || f + 2 <= frames_rendered + depth; });
+					if (f >= failed_at) {
+						return;
+					}
+					guard.unlock();
+
+					const clock::time_point began = clock::now();
+					Frame& frame = data[f % depth];
+					frame.index = f;
+					const bool ok = prepare(f, frame);
+					const double took = std::chrono::duration<double>(clock::now() - began).count();
+
+					guard.lock();
+					prepare_seconds += took;
+					prepared[f % depth] = f + 1;
+					failed_at = (!ok && f < failed_at) ? f : failed_at;
+					changed.notify_all();
+				}
+			};
+
+			// Frames are taken in order, so a raw stream (one writer) stays in order. Frames rendered before a failure are still written.
+			std::vector<std::unique_ptr<Frame_writer>> outputs;
+			for (unsigned w = 0; w < writers; w++) {
+				outputs.emplace_back(new Frame_writer(settings, target.width, target.height));
+				if (!outputs.back()->valid()) {
+					return stats;
+				}
+			}
+			auto write_worker = [&](Frame_writer* output) {
+				for (;;) {
+					std::unique_lock<std::mutex> guard(lock);
+					const size_t f = next_write++;
+					changed.wait(guard, [&] { return f >= failed_at || rendered[f % depth] == f + 1; });
+					if (f >= failed_at || rendered[f % depth] != f + 1) {
+						return;
+					}
+					guard.unlock();
+
+					const clock::time_point began = clock::now();
+					const bool ok = output->write(f, images[f % depth].data());
+					const double took = std::chrono::duration<double>(clock::now() - began).count();
+
+					guard.lock();
+					write_seconds += took;
+					written[f % depth] = f + 1;
+					stats.frames += ok ? 1 : 0;
+					failed_at = (!ok && f < failed_at) ? f : failed_at;
+					changed.notify_all();
+				}
+			};
+			std::vector<std::thread> workers;
+			for (unsigned t = 0; t < preparers; t++) {
+				workers.emplace_back(prepare_worker);
+			}
+			for (unsigned w = 0; w < writers; w++) {
+				workers.emplace_back(write_worker, outputs[w].get());
+			}
+
+			// Calling thread: upload and render each frame once its data is ready and its image slot has been written
+			for (size_t f = 0; f < frames; f++) {
+				{
+					std::unique_lock<std::mutex> guard(lock);
+					changed.wait(guard, [&] { return f >= failed_at || (prepared[f % depth] == f + 1 && (f < depth || written[f % depth] == f + 1 - depth)); });
+					if (f >= failed_at) {
+						break;
+					}
+				}
+
+				const clock::time_point began = clock::now();
+				bool ok = upload(figure, data[f % depth]) && figure.render();
+				if (ok && target.rgba->size() == image_bytes) {
+					std::memcpy(images[f % depth].data(), target.rgba->data(), image_bytes);
+				}
+				else if (ok) {
+					std::cerr << "W_VTK::Animation: the figure did not render into the target's buffer\n";
+					ok = false;
+				}
+				stats.render_seconds += std::chrono::duration<double>(clock::now() - began).count();
+
+				// A failed frame is never marked rendered, its slot still holds an older image
+				std::lock_guard<std::mutex> guard(lock);
+				if (ok) {
+					rendered[f % depth] = f + 1;
+					frames_rendered = f + 1;
+				}
+				failed_at = (!ok && f < failed_at) ? f : failed_at;
+				changed.notify_all();
+			}
+
+			{
+				// Nothing more will be rendered: workers still waiting for a later frame finish
+				std::lock_guard<std::mutex> guard(lock);
+				failed_at = (frames_rendered < failed_at) ? frames_rendered : failed_at;
+				changed.notify_all();
+			}
+			for (std::thread& worker : workers) {
+				worker.join();
+			}
+
+			stats.prepare_seconds = prepare_seconds;
+			stats.write_seconds = write_seconds;
+			stats.seconds = std::chrono::duration<double>(clock::now() - start).count();
+			return stats;
+		}
+	}
+}
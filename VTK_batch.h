@@ -0,0 +1,154 @@
+#pragma once
+
+/* ==================================================================================================
+ --------------- Batch renderer: many headless figures across a pool of worker threads --------------
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkRenderWindow.h>
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_decimation.h"
+#include "VTK_output.h"
+#include "VTK_parallel.h"
+#include "VTK_2D_plotter.h"
+#include "VTK_3D_plotter.h"
+
+/* External modules */
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <iostream>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	namespace Batch {
+
+		/* Which plotter a job goes through */
+		enum Kind {
+			LINES_2D, SCATTER_2D, LINE_3D, SCATTER_3D
+		};
+
+		/* ----- Notes -----:
+		One figure: the data and style arguments the standalone plotters take, plus where the image goes.
+		LINES_2D / SCATTER_2D	-> names + y (one per series) with x either one shared series_view or one per series
+		LINE_3D / SCATTER_3D	-> x, y, z with one series_view each; colour / background / width as the _3D plotters
+		The target must be RenderTarget::Png or RenderTarget::Rgba (its window is filled in by the worker).
+		Data is BORROWED by default, it must live until render() returns. */
+		struct Figure_job {
+
+			Kind kind;
+			std::vector<std::string> names;
+			std::vector<series_view> x, y, z;
+			std::string colour, background;
+			float width;
+			Ingestion mode;
+			LOD::Settings lod;
+			RenderTarget target;
+
+			Figure_job() : kind(LINES_2D), colour("Black"), background("White"), width(1.0f), mode(BORROW) {}
+		};
+
+		/* Per job timing */
+		struct Job_timing {
+			double seconds;		// Wall time building + rendering + writing the figure
+			unsigned worker;	// Which worker rendered it
+			bool rendered;		// False when the job was rejected or its image wasn't written (see std::cerr)
+		};
+
+		/* Draw one job into the worker's window, false if it is rejected or its image isn't written */
+		inline bool render_job(const Figure_job& job, vtkRenderWindow* window) {
+
+			if (!job.target.offscreen()) {
+				std::cerr << "W_VTK::Batch: jobs need a PNG or RGBA target\n";
+				return false;
+			}
+
+			RenderTarget target = job.target;
+			target.window = window;
+
+			// The pool already keeps every core busy, so don't let the LOD stage start threads of its own by default
+			LOD::Settings lod = job.lod;
+			if (lod.threads == 0) {
+				lod.threads = 1;
+			}
+
+			// The plotters check the series sizes themselves and return false (as does a failed write), so the result is passed back
+			switch (job.kind) {
+			case LINES_2D:
+			case SCATTER_2D:
+				if (job.y.empty() || (job.x.size() != 1 && job.x.size() != job.y.size())) {
+					std::cerr << "W_VTK::Batch: 2D jobs take at least one y series and one shared x or one x per y\n";
+					return false;
+				}
+				if (job.kind == LINES_2D) {
+					return (job.x.size() == 1) ? _2D::Line_plotter(job.names, job.x[0], job.y, job.mode, lod, target)
+						: _2D::Line_plotter(job.names, job.x, job.y, job.mode, lod, target);
+				}
+				return (job.x.size() == 1) ? _2D::Scatter_plotter(job.names, job.x[0], job.y, job.mode, target)
+					: _2D::Scatter_plotter(job.names, job.x, job.y, job.mode, target);
+
+			case LINE_3D:
+			case SCATTER_3D:
+				if (job.x.size() != 1 || job.y.size() != 1 || job.z.size() != 1) {
+					std::cerr << "W_VTK::Batch: 3D jobs take one x, y and z series\n";
+					return false;
+				}
+				if (job.kind == LINE_3D) {
+					return _3D::Line_plotter(job.x[0], job.y[0], job.z[0], job.colour.c_str(), job.background.c_str(), job.width, job.mode, target);
+				}
+				return _3D::Scatter_plotter(job.x[0], job.y[0], job.z[0], job.colour.c_str(), job.background.c_str(), job.width, job.mode, target);
+			}
+			std::cerr << "W_VTK::Batch: unknown job kind\n";
+			return false;
+		}
+
+		/* =================================================================================================================
+		Render every job across "threads" workers (0 -> one per hardware thread). Each worker creates ONE offscreen render window
+		and reuses it for all its jobs, so window/context creation is paid once per worker rather than once per figure.
+		Jobs are handed out one at a time from a shared counter so uneven figures still balance.
+		Returns timings in job order.
+		================================================================================================================= */
+		inline std::vector<Job_timing> render(const std::vector<Figure_job>& jobs, unsigned threads = 0) {
+
+			std::vector<Job_timing> timings(jobs.size());
+			if (jobs.empty()) {
+				return timings;
+			}
+			const unsigned workers = worker_count(threads, jobs.size());
+
+			std::atomic<size_t> next(0);
+			auto work = [&](unsigned worker) {
+
+				// Created on the thread that renders with it (GL contexts are per thread)
+				vtkSmartPointer<vtkRenderWindow> window = offscreen_window(640, 480);
+
+				for (size_t i = next.fetch_add(1); i < jobs.size(); i = next.fetch_add(1)) {
+
+					const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+					timings[i].rendered = render_job(jobs[i], window);
+					timings[i].seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+					timings[i].worker = worker;
+				}
+			};
+
+			std::vector<std::thread> pool;
+			pool.reserve(workers - 1);
+			for (unsigned t = 1; t < workers; t++) {
+				pool.emplace_back(work, t);
+			}
+			work(0);
+			for (std::thread& worker : pool) {
+				worker.join();
+			}
+
+			return timings;
+		}
+	}
+}
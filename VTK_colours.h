@@ -0,0 +1,187 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------ Colours: shared named colour table and a deterministic palette for series -------------
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkNamedColors.h>
+#include <vtkColor.h>
+
+/* External modules */
+#include <unordered_map>
+#include <string>
+#include <sstream>
+#include <atomic>
+#include <cstdint>
+#include <cctype>
+#include <cmath>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	/* =================================================================================================================
+	Immutable name -> colour table built ONCE per process from vtkNamedColors (which builds its map of several hundred names
+	every time one is constructed). Lookups are a hash map find, case insensitive like vtkNamedColors, and unknown names give
+	black like vtkNamedColors. Safe to use from several threads.
+	================================================================================================================= */
+	class Colour_table {
+
+	public:
+
+		/* Same call as vtkNamedColors so plotters can swap one for the other */
+		vtkColor3d GetColor3d(const std::string& name) const {
+
+			std::unordered_map<std::string, vtkColor3d>::const_iterator found = table.find(lower(name));
+			if (found == table.end()) {
+				return vtkColor3d(0.0, 0.0, 0.0);
+			}
+			return found->second;
+		}
+
+		bool ColorExists(const std::string& name) const { return table.count(lower(name)) != 0; }
+
+		static const Colour_table& instance() {
+			static const Colour_table shared;		// Thread safe one time construction
+			return shared;
+		}
+
+	private:
+
+		Colour_table() {
+
+			vtkSmartPointer<vtkNamedColors> colors = vtkSmartPointer<vtkNamedColors>::New();
+
+			// Names come back one per line
+			std::istringstream names(colors->GetColorNames());
+			std::string name;
+			while (std::getline(names, name)) {
+				if (!name.empty()) {
+					table[lower(name)] = colors->GetColor3d(name);
+				}
+			}
+		}
+
+		static std::string lower(const std::string& name) {
+			std::string out(name);
+			for (char& c : out) {
+				c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+			}
+			return out;
+		}
+
+		std::unordered_map<std::string, vtkColor3d> table;
+	};
+
+	/* The shared table: built on the first call, every plotter after that looks names up in it rather than constructing its
+	   own vtkNamedColors. Used as a drop in for a local vtkNamedColors: colors->GetColor3d("Red") */
+	inline const Colour_table* named_colours() {
+		return &Colour_table::instance();
+	}
+
+
+	/* =================================================================================================================
+	Deterministic palette for series that aren't given a colour (replaces std::rand() % 255).
+	Hues step round the colour wheel by the golden ratio from a seeded start, so consecutive series stay far apart and the
+	same seed always gives the same colours (also across threads, nothing is shared).
+	================================================================================================================= */
+	class Palette {
+
+	public:
+
+		explicit Palette(uint64_t seed = default_seed()) : hue(start_hue(seed)) {}
+
+		/* Colour for the next series (RGB in 0-1, as vtkPen::SetColorF takes) */
+		vtkColor3d next() {
+
+			const double golden = 0.618033988749895;
+			hue = std::fmod(hue + golden, 1.0);
+			return hsv(hue, 0.65, 0.85);
+		}
+
+		/* Seed the plotters use when they make their own palette (process wide) */
+		static uint64_t default_seed() { return seed_store().load(std::memory_order_relaxed); }
+		static void set_default_seed(uint64_t seed) { seed_store().store(seed, std::memory_order_relaxed); }
+
+	private:
+
+		static std::atomic<uint64_t>& seed_store() {
+			static std::atomic<uint64_t> seed(0);
+			return seed;
+		}
+
+		/* splitmix64 of the seed mapped to [0, 1) */
+		static double start_hue(uint64_t seed) {
+			uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			z = z ^ (z >> 31);
+			return static_cast<double>(z >> 11) / 9007199254740992.0;	// 2^53
+		}
+
+		static vtkColor3d hsv(double h, double s, double v) {
+
+			const double sector = h * 6.0;
+			const int i = static_cast<int>(sector) % 6;
+			const double f = sector - std::floor(sector);
+			const double p = v * (1.0 - s);
+			const double q = v * (1.0 - s * f);
+			const double t = v * (1.0 - s * (1.0 - f));
+
+			switch (i) {
+			case 0: return vtkColor3d(v, t, p);
+			case 1: return vtkColor3d(q, v, p);
+			case 2: return vtkColor3d(p, v, t);
+			case 3: return vtkColor3d(p, q, v);
+			case 4: return vtkColor3d(t, p, v);
+			default: return vtkColor3d(v, p, q);
+			}
+		}
+
+		double hue;
+	};
+
+	/* Colour maps for scalar fields (heatmaps, surfaces) */
+	enum Colour_map {
+		VIRIDIS, GREYS, COOLWARM, JET
+	};
+
+	/* =================================================================================================================
+	256 entry RGBA table of a colour map (entry 0 -> lowest value), linearly interpolated between the map's stops.
+	Built per call (a few microseconds); kernels index it instead of interpolating per value.
+	================================================================================================================= */
+	inline void colour_map_table(Colour_map map, unsigned char table[256][4], unsigned char alpha = 255) {
+
+		// Stops as position, r, g, b (0-255)
+		static const double viridis[][4] = { { 0.0, 68, 1, 84 }, { 0.125, 71, 44, 122 }, { 0.25, 59, 81, 139 }, { 0.375, 44, 113, 142 },
+			{ 0.5, 33, 144, 141 }, { 0.625, 39, 173, 129 }, { 0.75, 92, 200, 99 }, { 0.875, 170, 220, 50 }, { 1.0, 253, 231, 37 } };
+		static const double greys[][4] = { { 0.0, 0, 0, 0 }, { 1.0, 255, 255, 255 } };
+		static const double coolwarm[][4] = { { 0.0, 59, 76, 192 }, { 0.5, 221, 221, 221 }, { 1.0, 180, 4, 38 } };
+		static const double jet[][4] = { { 0.0, 0, 0, 128 }, { 0.125, 0, 0, 255 }, { 0.375, 0, 255, 255 }, { 0.625, 255, 255, 0 },
+			{ 0.875, 255, 0, 0 }, { 1.0, 128, 0, 0 } };
+
+		const double (*stops)[4] = viridis;
+		size_t count = sizeof(viridis) / sizeof(viridis[0]);
+		switch (map) {
+		case GREYS:		stops = greys; count = sizeof(greys) / sizeof(greys[0]); break;
+		case COOLWARM:	stops = coolwarm; count = sizeof(coolwarm) / sizeof(coolwarm[0]); break;
+		case JET:		stops = jet; count = sizeof(jet) / sizeof(jet[0]); break;
+		default:		break;
+		}
+
+		size_t stop = 0;
+		for (int i = 0; i < 256; i++) {
+			const double position = i / 255.0;
+			while (stop + 2 < count && position > stops[stop + 1][0]) {
+				stop++;
+			}
+			const double f = (position - stops[stop][0]) / (stops[stop + 1][0] - stops[stop][0]);
+			for (int c = 0; c < 3; c++) {
+				table[i][c] = static_cast<unsigned char>(stops[stop][c + 1] + f * (stops[stop + 1][c + 1] - stops[stop][c + 1]) + 0.5);
+			}
+			table[i][3] = alpha;
+		}
+	}
+}
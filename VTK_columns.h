@@ -0,0 +1,424 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------ Column helpers: raw data -> typed VTK arrays, e.g. vtkFloatArray (shared by 2D and 3D) -
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkFloatArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkTypeInt16Array.h>
+#include <vtkTypeUInt8Array.h>
+#include <vtkTable.h>
+
+/* Wrapper modules */
+#include "VTK_instrumentation.h"
+
+/* External modules */
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <iterator>
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+#if defined(__cpp_lib_span)
+#include <span>
+#endif
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	/* How raw data is handed to VTK when a plotter builds its vtkTable.
+	   COPY						-> Data is copied into memory owned by the collumn (one memcpy per collumn, no vtkVariant per point).
+								   The collumn comes from the Column_pool, so repeated plots of the same shape reuse the same memory.
+	   BORROW					-> The collumn (vtkFloatArray, vtkDoubleArray, ...) wraps the callers memory directly. Nothing is copied, so the memory MUST outlive the plot
+								   (i.e. until the render window is closed for chart/multiplot variants).
+	   TAKE_OWNERSHIP			-> As BORROW but VTK calls delete[] on the memory when the collumn is released. Memory must come from new T[] (T the value type).
+	   TAKE_OWNERSHIP_OF_BLOCK	-> For sets of rows cut out of ONE new T[] block (e.g. new float[numLines][numPoints]).
+								   The first row owns (and delete[]'s) the block, the other rows borrow from it. */
+	enum Ingestion {
+		COPY, BORROW, TAKE_OWNERSHIP, TAKE_OWNERSHIP_OF_BLOCK
+	};
+
+	/* Element types a series_view can hold, each backed by the VTK array of the same type (see make_column) */
+	enum Value_type {
+		FLOAT32, FLOAT64, INT32, INT16, UINT8
+	};
+
+	inline size_t value_size(Value_type type) {
+		switch (type) {
+		case FLOAT64:	return sizeof(double);
+		case INT32:		return sizeof(int32_t);
+		case INT16:		return sizeof(int16_t);
+		case UINT8:		return sizeof(uint8_t);
+		default:		return sizeof(float);
+		}
+	}
+
+	/* Non-owning view of runtime sized data: pointer + number of points, with an optional stride (in values)
+	   for interleaved data (e.g. x0,y0,z0,x1,y1,z1 -> X = series_view(p, n, 3), Y = series_view(p + 1, n, 3), ...).
+	   Converts implicitly from std::vector (and std::span when available) so runtime sized data can be passed straight
+	   to the plotters. Values are float, double, int32, int16 or uint8: the table based 2D / 3D plotters wrap every type
+	   in its own VTK array (no float copy). Float only code (level of detail, point clouds, Figure collumns) reads other
+	   types through operator[], i.e. converts them while it copies. */
+	struct series_view {
+
+		const float* data;		// The values when type == FLOAT32, nullptr otherwise (see values)
+		size_t size;
+		ptrdiff_t stride;
+		Value_type type;
+		const void* values;		// The values, any type
+
+		series_view() : data(nullptr), size(0), stride(1), type(FLOAT32), values(nullptr) {}
+		series_view(const float* data, size_t size, ptrdiff_t stride = 1) : data(data), size(size), stride(stride), type(FLOAT32), values(data) {}
+		series_view(const double* p, size_t size, ptrdiff_t stride = 1) : data(nullptr), size(size), stride(stride), type(FLOAT64), values(p) {}
+		series_view(const int32_t* p, size_t size, ptrdiff_t stride = 1) : data(nullptr), size(size), stride(stride), type(INT32), values(p) {}
+		series_view(const int16_t* p, size_t size, ptrdiff_t stride = 1) : data(nullptr), size(size), stride(stride), type(INT16), values(p) {}
+		series_view(const uint8_t* p, size_t size, ptrdiff_t stride = 1) : data(nullptr), size(size), stride(stride), type(UINT8), values(p) {}
+		series_view(const std::vector<float>& vec) : series_view(vec.data(), vec.size()) {}
+		series_view(const std::vector<double>& vec) : series_view(vec.data(), vec.size()) {}
+		series_view(const std::vector<int32_t>& vec) : series_view(vec.data(), vec.size()) {}
+		series_view(const std::vector<int16_t>& vec) : series_view(vec.data(), vec.size()) {}
+		series_view(const std::vector<uint8_t>& vec) : series_view(vec.data(), vec.size()) {}
+#if defined(__cpp_lib_span)
+		series_view(std::span<const float> span) : series_view(span.data(), span.size()) {}
+		series_view(std::span<const double> span) : series_view(span.data(), span.size()) {}
+		series_view(std::span<const int32_t> span) : series_view(span.data(), span.size()) {}
+		series_view(std::span<const int16_t> span) : series_view(span.data(), span.size()) {}
+		series_view(std::span<const uint8_t> span) : series_view(span.data(), span.size()) {}
+#endif
+
+		/* Floats one after the other, i.e. .data can be read directly */
+		bool contiguous() const { return stride == 1 && type == FLOAT32; }
+
+		/* Value i as a float (converted for the other types) */
+		float operator[](size_t i) const {
+			if (type == FLOAT32) {
+				return data[i * stride];
+			}
+			switch (type) {
+			case FLOAT64:	return static_cast<float>(static_cast<const double*>(values)[i * stride]);
+			case INT32:		return static_cast<float>(static_cast<const int32_t*>(values)[i * stride]);
+			case INT16:		return static_cast<float>(static_cast<const int16_t*>(values)[i * stride]);
+			default:		return static_cast<float>(static_cast<const uint8_t*>(values)[i * stride]);
+			}
+		}
+	};
+
+	/* Free memory handed over with TAKE_OWNERSHIP that did not end up wrapped by a collumn (e.g. it was decimated into a new one).
+	   Pass the per-row mode (block_row_mode) for sets of rows so a block is freed once. */
+	inline void release_unwrapped(const series_view& view, Ingestion mode) {
+		if (mode == TAKE_OWNERSHIP || mode == TAKE_OWNERSHIP_OF_BLOCK) {
+			switch (view.type) {
+			case FLOAT64:	delete[] static_cast<const double*>(view.values); break;
+			case INT32:		delete[] static_cast<const int32_t*>(view.values); break;
+			case INT16:		delete[] static_cast<const int16_t*>(view.values); break;
+			case UINT8:		delete[] static_cast<const uint8_t*>(view.values); break;
+			default:		delete[] view.data; break;
+			}
+		}
+	}
+
+	/* =================================================================================================================
+	Process wide pool of collumn storage for copies (COPY, strided gathers and level of detail output), keyed by value type
+	and number of values. Plotting the same shape again (e.g. a figure per timestep) gets the collumns of the last plot back
+	instead of allocating (and page faulting) new ones.
+	There is no explicit release: the pool keeps a reference to every collumn it made and a collumn is idle again once only
+	the pool holds it, i.e. when the table / chart that used it is gone. Collumns are kept while the pool holds less than
+	capacity() bytes (in use or idle), bigger requests are allocated as before. trim() frees the idle ones.
+	Safe to use from several threads.
+	================================================================================================================= */
+	class Column_pool {
+
+	public:
+
+		static Column_pool& shared() {
+			static Column_pool pool;		// Thread safe one time construction
+			return pool;
+		}
+
+		/* A collumn of numPoints values (Array holds the values of type), idle from an earlier plot or new.
+		   reused tells which so the caller knows whether memory was allocated. */
+		template<typename Array>
+		vtkSmartPointer<Array> acquire(Value_type type, vtkIdType numPoints, bool& reused) {
+
+			const Key key(type, numPoints);
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				std::map<Key, std::vector<vtkSmartPointer<vtkDataArray>>>::iterator bucket = buckets.find(key);
+				if (bucket != buckets.end()) {
+					for (size_t i = 0; i < bucket->second.size(); i++) {
+						vtkDataArray* column = bucket->second[i];
+						if (column->GetReferenceCount() == 1 && column->GetNumberOfTuples() == numPoints) {
+							reused = true;
+							return vtkSmartPointer<Array>(static_cast<Array*>(column));
+						}
+					}
+				}
+			}
+
+			// Allocated outside the lock so threads building big collumns don't wait on each other
+			vtkSmartPointer<Array> column = vtkSmartPointer<Array>::New();
+			column->SetNumberOfTuples(numPoints);
+			reused = false;
+
+			const size_t bytes = static_cast<size_t>(numPoints) * value_size(type);
+			std::lock_guard<std::mutex> guard(lock);
+			if (held + bytes <= limit) {
+				buckets[key].push_back(column);
+				held += bytes;
+			}
+			return column;
+		}
+
+		/* Free the collumns no plot is using */
+		void trim() {
+
+			std::lock_guard<std::mutex> guard(lock);
+			for (std::map<Key, std::vector<vtkSmartPointer<vtkDataArray>>>::iterator bucket = buckets.begin(); bucket != buckets.end(); ) {
+				std::vector<vtkSmartPointer<vtkDataArray>>& columns = bucket->second;
+				for (size_t i = 0; i < columns.size(); ) {
+					if (columns[i]->GetReferenceCount() == 1) {
+						held -= static_cast<size_t>(bucket->first.second) * value_size(bucket->first.first);
+						columns[i] = columns.back();
+						columns.pop_back();
+					}
+					else {
+						i++;
+					}
+				}
+				bucket = columns.empty() ? buckets.erase(bucket) : std::next(bucket);
+			}
+		}
+
+		/* Most bytes the pool keeps (default 256 MB, 0 -> no pooling). Lowering it frees idle collumns. */
+		void set_capacity(size_t bytes) {
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				limit = bytes;
+			}
+			trim();
+		}
+
+		size_t capacity() const {
+			std::lock_guard<std::mutex> guard(lock);
+			return limit;
+		}
+
+		/* Bytes held (collumns in use and idle) */
+		size_t bytes_held() const {
+			std::lock_guard<std::mutex> guard(lock);
+			return held;
+		}
+
+	private:
+
+		typedef std::pair<Value_type, vtkIdType> Key;
+
+		Column_pool() : held(0), limit(size_t(256) << 20) {}
+		Column_pool(const Column_pool&) = delete;
+		Column_pool& operator=(const Column_pool&) = delete;
+
+		mutable std::mutex lock;
+		std::map<Key, std::vector<vtkSmartPointer<vtkDataArray>>> buckets;
+		size_t held;
+		size_t limit;
+	};
+
+	/* Collumn to copy numPoints values into: from the pool when given one, else new (Figure refills and rewraps its own
+	   collumns, so it doesn't use the pool). Counts the collumn and the bytes allocated for it. */
+	template<typename Array>
+	vtkSmartPointer<Array> copy_column(const char* name, Value_type type, vtkIdType numPoints, Column_pool* pool) {
+
+		vtkSmartPointer<Array> arr;
+		bool reused = false;
+		if (pool) {
+			arr = pool->template acquire<Array>(type, numPoints, reused);
+		}
+		else {
+			arr = vtkSmartPointer<Array>::New();
+			arr->SetNumberOfTuples(numPoints);
+		}
+		arr->SetName(name);
+		arr->Modified();		// A reused collumn holds the last plots values (and cached range) until it's written
+
+		Instrumentation::count_column(reused ? 0 : static_cast<size_t>(numPoints) * value_size(type), reused);
+		return arr;
+	}
+
+	/* Build a named vtkFloatArray collumn of numPoints values from contiguous float memory.
+	   Cost is O(1) for BORROW/TAKE_OWNERSHIP and a single memcpy for COPY. */
+	inline vtkSmartPointer<vtkFloatArray> make_column(const char* name, const float* data, vtkIdType numPoints, Ingestion mode) {
+
+		vtkSmartPointer<vtkFloatArray> arr = vtkSmartPointer<vtkFloatArray>::New();
+		arr->SetName(name);
+
+		switch (mode) {
+		case BORROW:
+			// save = 1 -> VTK never frees the memory. VTK only reads plot input so casting away const is safe here.
+			arr->SetArray(const_cast<float*>(data), numPoints, 1);
+			break;
+
+		case TAKE_OWNERSHIP:
+		case TAKE_OWNERSHIP_OF_BLOCK:	// A single collumn is its own block
+			arr->SetArray(const_cast<float*>(data), numPoints, 0, vtkAbstractArray::VTK_DATA_ARRAY_DELETE);
+			break;
+
+		default:
+			arr->SetNumberOfTuples(numPoints);
+			std::memcpy(arr->GetPointer(0), data, numPoints * sizeof(float));
+			break;
+		}
+
+		// Only copies allocate, borrowed/adopted collumns wrap the callers memory
+		const bool copied = (mode != BORROW && mode != TAKE_OWNERSHIP && mode != TAKE_OWNERSHIP_OF_BLOCK);
+		Instrumentation::count_column(copied ? numPoints * sizeof(float) : 0);
+
+		return arr;
+	}
+
+	/* Float collumn from a series_view (for code that needs float, e.g. Figure). Strided views cannot be wrapped by a
+	   vtkFloatArray so they are always gathered into a new collumn (mode is ignored and the caller keeps ownership of the
+	   strided memory). Other value types are converted the same way; contiguous ones handed over are freed once copied.
+	   Copies come from pool when one is given (see Column_pool). */
+	inline vtkSmartPointer<vtkFloatArray> make_float_column(const char* name, const series_view& view, Ingestion mode, Column_pool* pool = nullptr) {
+
+		if (view.contiguous() && (mode != COPY || pool == nullptr)) {
+			return make_column(name, view.data, static_cast<vtkIdType>(view.size), mode);
+		}
+
+		vtkSmartPointer<vtkFloatArray> arr = copy_column<vtkFloatArray>(name, FLOAT32, static_cast<vtkIdType>(view.size), pool);
+
+		float* out = arr->GetPointer(0);
+		if (view.contiguous()) {
+			std::memcpy(out, view.data, view.size * sizeof(float));
+		}
+		else {
+			for (size_t i = 0; i < view.size; i++) {
+				out[i] = view[i];
+			}
+		}
+		if (view.stride == 1) {
+			release_unwrapped(view, mode);
+		}
+		return arr;
+	}
+
+	/* Collumn of the view's own type (Array holds T): wrapped in O(1) for BORROW/TAKE_OWNERSHIP, else one copy or gather
+	   into a collumn from pool (when given) */
+	template<typename Array, typename T>
+	vtkSmartPointer<vtkDataArray> make_typed_column(const char* name, const series_view& view, Ingestion mode, Column_pool* pool = nullptr) {
+
+		const T* values = static_cast<const T*>(view.values);
+		const vtkIdType numPoints = static_cast<vtkIdType>(view.size);
+		if (view.stride == 1 && mode != COPY) {
+			vtkSmartPointer<Array> arr = vtkSmartPointer<Array>::New();
+			arr->SetName(name);
+
+			// VTK only reads plot input so casting away const is safe here (see make_column above)
+			if (mode == BORROW) {
+				arr->SetArray(const_cast<T*>(values), numPoints, 1);
+			}
+			else {
+				arr->SetArray(const_cast<T*>(values), numPoints, 0, vtkAbstractArray::VTK_DATA_ARRAY_DELETE);
+			}
+			Instrumentation::count_column(0);
+			return arr;
+		}
+
+		vtkSmartPointer<Array> arr = copy_column<Array>(name, view.type, numPoints, pool);
+		T* out = arr->GetPointer(0);
+		if (view.stride == 1) {
+			std::memcpy(out, values, view.size * sizeof(T));
+		}
+		else {
+			for (size_t i = 0; i < view.size; i++) {
+				out[i] = values[i * view.stride];
+			}
+		}
+		return arr;
+	}
+
+	/* Same again from a series_view, in the VTK array matching its value type (double -> vtkDoubleArray, int16 ->
+	   vtkTypeInt16Array, ...) so no type is converted to float. Strided views are gathered as for make_float_column.
+	   This is what the plotters use, so their copies come from the shared Column_pool. */
+	inline vtkSmartPointer<vtkDataArray> make_column(const char* name, const series_view& view, Ingestion mode) {
+
+		Column_pool* pool = &Column_pool::shared();
+		switch (view.type) {
+		case FLOAT64:	return make_typed_column<vtkDoubleArray, double>(name, view, mode, pool);
+		case INT32:		return make_typed_column<vtkTypeInt32Array, int32_t>(name, view, mode, pool);
+		case INT16:		return make_typed_column<vtkTypeInt16Array, int16_t>(name, view, mode, pool);
+		case UINT8:		return make_typed_column<vtkTypeUInt8Array, uint8_t>(name, view, mode, pool);
+		default:		return make_float_column(name, view, mode, pool);
+		}
+	}
+
+	/* Swap new data into an existing collumn (e.g. a Figure re-plotting a timestep) so the table and plot are kept.
+	   BORROW/TAKE_OWNERSHIP rewrap in O(1). COPY and strided views are written into the collumns own buffer, which VTK only
+	   reallocates when it has to grow (as do views of other value types, converted to float). "wraps" tracks whether the collumn currently wraps memory it didn't allocate,
+	   so a copy never writes into the previous callers memory. */
+	inline void refill_column(vtkFloatArray* column, const series_view& view, Ingestion mode, bool& wraps) {
+
+		const vtkIdType numPoints = static_cast<vtkIdType>(view.size);
+
+		if (view.contiguous() && mode != COPY) {
+			if (mode == BORROW) {
+				column->SetArray(const_cast<float*>(view.data), numPoints, 1);
+			}
+			else {
+				column->SetArray(const_cast<float*>(view.data), numPoints, 0, vtkAbstractArray::VTK_DATA_ARRAY_DELETE);
+			}
+			wraps = true;
+			Instrumentation::count_column(0);
+		}
+		else {
+			if (wraps) {
+				column->Initialize();
+				wraps = false;
+			}
+			column->SetNumberOfTuples(numPoints);
+
+			float* out = column->GetPointer(0);
+			if (view.contiguous()) {
+				std::memcpy(out, view.data, numPoints * sizeof(float));
+			}
+			else {
+				for (size_t i = 0; i < view.size; i++) {
+					out[i] = view[i];
+				}
+			}
+			Instrumentation::count_column(view.size * sizeof(float));
+			if (view.stride == 1) {
+				release_unwrapped(view, mode);
+			}
+		}
+		column->Modified();
+	}
+
+	/* Ingestion mode for row "row" out of a set of rows (e.g. data[numLines][numPoints] or a list of series_views).
+	   With TAKE_OWNERSHIP_OF_BLOCK only row 0 owns (and delete[]'s) the block and the other rows borrow.
+	   The rows may be in different tables (e.g. a table per line): row 0's table frees the block for all of them, so the
+	   tables sharing a block must be dropped together, as they are when the chart holding them is. */
+	inline Ingestion block_row_mode(Ingestion mode, int row) {
+		if (mode == TAKE_OWNERSHIP_OF_BLOCK) {
+			return (row == 0) ? TAKE_OWNERSHIP : BORROW;
+		}
+		return mode;
+	}
+
+	/* C-array variants (e.g. float data[numLines][numPoints]) are always one block, so ownership is of the block */
+	inline Ingestion as_block(Ingestion mode) {
+		return (mode == TAKE_OWNERSHIP) ? TAKE_OWNERSHIP_OF_BLOCK : mode;
+	}
+}
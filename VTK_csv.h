@@ -0,0 +1,283 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------ CSV / delimited text input: parsed in parallel straight into plot collumns -------------
+ ==================================================================================================*/
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_parallel.h"
+#include "VTK_mapped.h"
+
+/* External modules */
+#include <vector>
+#include <string>
+#include <iostream>
+#include <chrono>
+#include <atomic>
+#include <limits>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+#include <charconv>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	/* ----- Notes -----:
+	load_csv maps the file (see VTK_mapped.h, no read into a buffer) and parses it in parallel:
+		1. the body is cut into chunks (several per thread) at line breaks and each chunk counts its rows
+		2. the collumns are allocated once for the total and every chunk parses its rows straight into place
+	Numbers are parsed with std::from_chars (no iostreams, no locale). Every collumn comes out as a std::vector<float>
+	so the result plugs into the plotters as it is:
+		Csv_table csv = load_csv("log.csv");
+		_2D::Line_plotter(csv.names_from(1), csv.column(0), csv.views_from(1));	// collumn 0 as x, the rest as lines
+	Numeric fields only (no quoted fields in the body). Empty or unparseable fields and missing trailing fields are NaN
+	and counted in bad_fields; the level of detail kernels assume finite data, so check it before using LOD.
+	seconds / throughput() report the load so disk and parser speed can be checked (e.g. multi-GB/s on NVMe). */
+
+	/* Settings for load_csv */
+	struct Csv_settings {
+
+		char delimiter;		// Field separator (',' ';' '\t' ' ' ...)
+		bool header;		// First (non skipped) line holds the collumn names
+		size_t skip_rows;	// Lines skipped before the header / data (e.g. a comment block)
+		unsigned threads;	// Worker threads (0 -> one per hardware thread)
+
+		Csv_settings(char delimiter = ',', bool header = true, size_t skip_rows = 0, unsigned threads = 0)
+			: delimiter(delimiter), header(header), skip_rows(skip_rows), threads(threads) {}
+	};
+
+	/* Collumns of a loaded file */
+	struct Csv_table {
+
+		std::vector<std::string> names;				// From the header, or "Collumn: i" without one
+		std::vector<std::vector<float>> columns;	// One per field, all rows long
+		size_t rows;
+		size_t bad_fields;							// Fields that didn't parse (NaN)
+		size_t bytes;								// File size
+		double seconds;								// Map + count + parse
+
+		Csv_table() : rows(0), bad_fields(0), bytes(0), seconds(0.0) {}
+
+		bool empty() const { return columns.empty(); }
+
+		/* GB/s over the whole file */
+		double throughput() const { return (seconds > 0.0) ? static_cast<double>(bytes) / seconds * 1e-9 : 0.0; }
+
+		/* Collumn by position or by name (empty view if there is none) */
+		series_view column(size_t c) const { return (c < columns.size()) ? series_view(columns[c]) : series_view(); }
+
+		series_view column(const std::string& name) const {
+			for (size_t c = 0; c < names.size(); c++) {
+				if (names[c] == name) {
+					return column(c);
+				}
+			}
+			std::cerr << "W_VTK::Csv_table: no collumn named " << name << "\n";
+			return series_view();
+		}
+
+		/* Collumns first .. end as views / names, e.g. every collumn after the x collumn for the multi-line plotters */
+		std::vector<series_view> views_from(size_t first) const {
+			std::vector<series_view> views;
+			for (size_t c = first; c < columns.size(); c++) {
+				views.push_back(series_view(columns[c]));
+			}
+			return views;
+		}
+
+		std::vector<std::string> names_from(size_t first) const {
+			return (first < names.size()) ? std::vector<std::string>(names.begin() + first, names.end()) : std::vector<std::string>();
+		}
+	};
+
+	namespace Csv {
+
+		/* Next line of [p, end): returns where it ends (before the '\n') and moves p past the line break */
+		inline const char* next_line(const char*& p, const char* end) {
+
+			const char* line_break = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+			const char* line_end = line_break ? line_break : end;
+			p = line_break ? line_break + 1 : end;
+			return line_end;
+		}
+
+		/* Line [begin, end) without a trailing '\r' */
+		inline const char* trim_cr(const char* begin, const char* end) {
+			return (end > begin && end[-1] == '\r') ? end - 1 : end;
+		}
+
+		/* One field -> float. Leading/trailing spaces and a leading '+' are allowed. */
+		inline bool parse_field(const char* begin, const char* end, float& value) {
+
+			while (begin < end && (*begin == ' ' || *begin == '\t')) {
+				begin++;
+			}
+			while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) {
+				end--;
+			}
+			if (begin < end && *begin == '+') {
+				begin++;
+			}
+			const std::from_chars_result result = std::from_chars(begin, end, value);
+			return result.ec == std::errc() && result.ptr == end && begin < end;
+		}
+
+		/* Split one line into fields, calling field(index, begin, end) for each */
+		template<typename Function>
+		void split(const char* begin, const char* end, char delimiter, Function field) {
+
+			size_t index = 0;
+			for (const char* start = begin; ; index++) {
+				const char* stop = static_cast<const char*>(std::memchr(start, delimiter, static_cast<size_t>(end - start)));
+				if (stop == nullptr) {
+					field(index, start, end);
+					return;
+				}
+				field(index, start, stop);
+				start = stop + 1;
+			}
+		}
+
+		/* Header names lose surrounding spaces and quotes */
+		inline std::string clean_name(const char* begin, const char* end) {
+
+			while (begin < end && (*begin == ' ' || *begin == '\t' || *begin == '"' || *begin == '\'')) {
+				begin++;
+			}
+			while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '"' || end[-1] == '\'')) {
+				end--;
+			}
+			return std::string(begin, end);
+		}
+	}
+
+	/* =================================================================================================================
+	Load a delimited text file of numbers into float collumns, in parallel. Returns an empty table on failure.
+	================================================================================================================= */
+	inline Csv_table load_csv(const std::string& path, const Csv_settings& settings = Csv_settings()) {
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		Csv_table table;
+
+		Mapped_file file(path, SEQUENTIAL);
+		if (!file.valid()) { return table; }
+		table.bytes = file.size();
+
+		const char* p = reinterpret_cast<const char*>(file.data());
+		const char* const end = p + file.size();
+
+		// ----- Skipped lines and header (serial, they are short) -----
+		for (size_t r = 0; r < settings.skip_rows && p < end; r++) {
+			Csv::next_line(p, end);
+		}
+
+		std::vector<std::string> names;
+		if (settings.header && p < end) {
+			const char* line = p;
+			const char* line_end = Csv::trim_cr(line, Csv::next_line(p, end));
+			Csv::split(line, line_end, settings.delimiter, [&](size_t, const char* b, const char* e) {
+				names.push_back(Csv::clean_name(b, e));
+			});
+		}
+
+		// Without a header the first data line decides the number of collumns
+		size_t columns = names.size();
+		if (!settings.header) {
+			const char* q = p;
+			while (q < end && columns == 0) {
+				const char* line = q;
+				const char* line_end = Csv::trim_cr(line, Csv::next_line(q, end));
+				if (line_end > line) {
+					Csv::split(line, line_end, settings.delimiter, [&](size_t, const char*, const char*) { columns++; });
+				}
+			}
+			for (size_t c = 0; c < columns; c++) {
+				names.push_back("Collumn: " + std::to_string(c));
+			}
+		}
+		if (columns == 0) {
+			std::cerr << "W_VTK::load_csv: " << path << ": no collumns found\n";
+			return table;
+		}
+
+		// ----- 1. Chunks cut at line breaks, rows counted per chunk (empty lines are not rows) -----
+		const size_t body = static_cast<size_t>(end - p);
+		const size_t min_chunk = 1 << 20;
+		const size_t chunks = (std::max)(static_cast<size_t>(1), (std::min)(body / min_chunk + 1, static_cast<size_t>(worker_count(settings.threads, body / min_chunk + 1)) * 4));
+
+		std::vector<const char*> cuts(chunks + 1);
+		cuts[0] = p;
+		cuts[chunks] = end;
+		for (size_t c = 1; c < chunks; c++) {
+			const char* at = p + c * (body / chunks);
+			const char* line_break = (at < end) ? static_cast<const char*>(std::memchr(at, '\n', static_cast<size_t>(end - at))) : nullptr;
+			cuts[c] = line_break ? line_break + 1 : end;
+			if (cuts[c] < cuts[c - 1]) {
+				cuts[c] = cuts[c - 1];
+			}
+		}
+
+		std::vector<size_t> first_row(chunks + 1, 0);
+		parallel_for(chunks, settings.threads, [&](size_t c) {
+			size_t count = 0;
+			for (const char* q = cuts[c]; q < cuts[c + 1]; ) {
+				const char* line = q;
+				count += (Csv::trim_cr(line, Csv::next_line(q, cuts[c + 1])) > line) ? 1 : 0;
+			}
+			first_row[c + 1] = count;
+		});
+		for (size_t c = 0; c < chunks; c++) {
+			first_row[c + 1] += first_row[c];
+		}
+		table.rows = first_row[chunks];
+
+		// ----- 2. Collumns allocated once, every chunk parses into its own rows -----
+		table.columns.assign(columns, std::vector<float>(table.rows));
+		std::vector<float*> out(columns);
+		for (size_t c = 0; c < columns; c++) {
+			out[c] = table.columns[c].data();
+		}
+
+		const float nan = std::numeric_limits<float>::quiet_NaN();
+		std::atomic<size_t> bad_fields(0);
+		parallel_for(chunks, settings.threads, [&](size_t c) {
+			size_t row = first_row[c];
+			size_t bad = 0;
+			for (const char* q = cuts[c]; q < cuts[c + 1]; ) {
+				const char* line = q;
+				const char* line_end = Csv::trim_cr(line, Csv::next_line(q, cuts[c + 1]));
+				if (line_end == line) {
+					continue;
+				}
+				size_t fields = 0;
+				Csv::split(line, line_end, settings.delimiter, [&](size_t index, const char* b, const char* e) {
+					if (index >= columns) {
+						return;		// Extra fields are ignored
+					}
+					if (!Csv::parse_field(b, e, out[index][row])) {
+						out[index][row] = nan;
+						bad++;
+					}
+					fields = index + 1;
+				});
+				for (size_t f = fields; f < columns; f++) {
+					out[f][row] = nan;
+					bad++;
+				}
+				row++;
+			}
+			bad_fields += bad;
+		});
+
+		table.names = names;
+		table.bad_fields = bad_fields.load();
+		table.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (table.bad_fields > 0) {
+			std::cerr << "W_VTK::load_csv: " << path << ": " << table.bad_fields << " fields did not parse (set to NaN)\n";
+		}
+		return table;
+	}
+}
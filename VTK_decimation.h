@@ -0,0 +1,555 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------ Level of detail for large 2D line series: per-bucket min/max and LTTB -----------------
+ ==================================================================================================*/
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_parallel.h"
+
+/* External modules */
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <numeric>
+#include <memory>
+
+/* SSE2 is part of x86-64 so this is on for practically every desktop build. Other targets use the scalar loops. */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define W_VTK_SSE2 1
+#endif
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	namespace LOD {
+
+		/* Decimation methods.
+		   MIN_MAX	-> split the series into one bucket per pixel and keep the min and max point of each (spikes survive). 2 points per pixel.
+		   LTTB		-> Largest-Triangle-Three-Buckets: one point per bucket, picked to keep the visual shape. 1 point per pixel. */
+		enum Method {
+			NONE, MIN_MAX, LTTB
+		};
+
+		/* Level of detail settings passed to the 2D line plotters */
+		struct Settings {
+
+			Method method;
+			size_t pixels;		// Pixel budget, i.e. the width of the plot area (render window is 640 wide by default)
+			unsigned threads;	// Worker threads used across series (0 -> one per hardware thread)
+			bool follow_zoom;	// Chart variant only: re-decimate the visible x window on zoom/pan (always MIN_MAX, see ZoomIndex)
+
+			Settings(Method method = NONE, size_t pixels = 640, unsigned threads = 0, bool follow_zoom = false)
+				: method(method), pixels(pixels), threads(threads), follow_zoom(follow_zoom) {}
+
+			// Number of points a decimated series is reduced to
+			size_t output_points() const { return (method == MIN_MAX) ? 2 * pixels : pixels; }
+		};
+
+		/* A decimated series (owned, small: at most Settings::output_points() points) */
+		struct Series {
+			std::vector<float> x, y;
+		};
+
+
+		/* =================================================================================================================
+		Vectorized kernels (SSE2 with scalar fallback). Data is assumed finite (no NaNs).
+		================================================================================================================= */
+
+		/* Min and max of n >= 1 contiguous floats */
+		inline void min_max(const float* p, size_t n, float& lo, float& hi) {
+
+			size_t i = 0;
+			lo = p[0];
+			hi = p[0];
+#if defined(W_VTK_SSE2)
+			if (n >= 8) {
+				// Two accumulators per bound to hide the min/max latency
+				__m128 lo0 = _mm_loadu_ps(p), lo1 = _mm_loadu_ps(p + 4);
+				__m128 hi0 = lo0, hi1 = lo1;
+				for (i = 8; i + 8 <= n; i += 8) {
+					const __m128 a = _mm_loadu_ps(p + i);
+					const __m128 b = _mm_loadu_ps(p + i + 4);
+					lo0 = _mm_min_ps(lo0, a);
+					hi0 = _mm_max_ps(hi0, a);
+					lo1 = _mm_min_ps(lo1, b);
+					hi1 = _mm_max_ps(hi1, b);
+				}
+				float l[4], h[4];
+				_mm_storeu_ps(l, _mm_min_ps(lo0, lo1));
+				_mm_storeu_ps(h, _mm_max_ps(hi0, hi1));
+				lo = (std::min)((std::min)(l[0], l[1]), (std::min)(l[2], l[3]));
+				hi = (std::max)((std::max)(h[0], h[1]), (std::max)(h[2], h[3]));
+			}
+#endif
+			for (; i < n; i++) {
+				lo = (std::min)(lo, p[i]);
+				hi = (std::max)(hi, p[i]);
+			}
+		}
+
+		/* Sum of n contiguous floats (accumulated per lane, then in double) */
+		inline double sum(const float* p, size_t n) {
+
+			size_t i = 0;
+			double total = 0.0;
+#if defined(W_VTK_SSE2)
+			if (n >= 4) {
+				__m128 acc = _mm_setzero_ps();
+				for (; i + 4 <= n; i += 4) {
+					acc = _mm_add_ps(acc, _mm_loadu_ps(p + i));
+				}
+				float lanes[4];
+				_mm_storeu_ps(lanes, acc);
+				total = (double)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+			}
+#endif
+			for (; i < n; i++) {
+				total += p[i];
+			}
+			return total;
+		}
+
+		/* Index (relative to x/y) of the point in [0, n) maximising |k0 + kx * x + ky * y| (the LTTB triangle area, times 2).
+		   Ties go to the lowest index. */
+		inline size_t max_area(const float* x, const float* y, size_t n, float k0, float kx, float ky) {
+
+			size_t i = 0, best = 0;
+			float bestArea = -1.0f;
+#if defined(W_VTK_SSE2)
+			if (n >= 4) {
+				const __m128 vk0 = _mm_set1_ps(k0), vkx = _mm_set1_ps(kx), vky = _mm_set1_ps(ky);
+				const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+				__m128 vBest = _mm_set1_ps(-1.0f);
+				__m128i vBestIdx = _mm_setzero_si128();
+				__m128i vIdx = _mm_setr_epi32(0, 1, 2, 3);
+				const __m128i four = _mm_set1_epi32(4);
+
+				for (; i + 4 <= n; i += 4) {
+					__m128 area = _mm_add_ps(vk0, _mm_add_ps(_mm_mul_ps(vkx, _mm_loadu_ps(x + i)), _mm_mul_ps(vky, _mm_loadu_ps(y + i))));
+					area = _mm_and_ps(area, absMask);
+					const __m128 better = _mm_cmpgt_ps(area, vBest);
+					const __m128i betterI = _mm_castps_si128(better);
+					vBest = _mm_or_ps(_mm_and_ps(better, area), _mm_andnot_ps(better, vBest));
+					vBestIdx = _mm_or_si128(_mm_and_si128(betterI, vIdx), _mm_andnot_si128(betterI, vBestIdx));
+					vIdx = _mm_add_epi32(vIdx, four);
+				}
+
+				float areas[4];
+				int idx[4];
+				_mm_storeu_ps(areas, vBest);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(idx), vBestIdx);
+				for (int lane = 0; lane < 4; lane++) {
+					const size_t laneIdx = static_cast<size_t>(idx[lane]);
+					if (areas[lane] > bestArea || (areas[lane] == bestArea && laneIdx < best)) {
+						bestArea = areas[lane];
+						best = laneIdx;
+					}
+				}
+			}
+#endif
+			for (; i < n; i++) {
+				const float area = std::fabs(k0 + kx * x[i] + ky * y[i]);
+				if (area > bestArea) {
+					bestArea = area;
+					best = i;
+				}
+			}
+			return best;
+		}
+
+
+		/* =================================================================================================================
+		Single series decimation
+		================================================================================================================= */
+
+		/* Copy a series that is already within budget */
+		inline void copy_series(const series_view& x, const series_view& y, Series& out) {
+
+			out.x.resize(y.size);
+			out.y.resize(y.size);
+			for (size_t i = 0; i < y.size; i++) {
+				out.x[i] = x[i];
+				out.y[i] = y[i];
+			}
+		}
+
+		/* Per-bucket min/max. Keeps both extremes of each of "buckets" equal-count buckets in index order, so the decimated
+		   line draws exactly the vertical extent the full line would in each pixel column. */
+		inline void min_max_decimate(const series_view& x, const series_view& y, size_t buckets, Series& out) {
+
+			const size_t n = y.size;
+			if (buckets == 0 || n <= 2 * buckets) {
+				copy_series(x, y, out);
+				return;
+			}
+
+			out.x.clear();
+			out.y.clear();
+			out.x.reserve(2 * buckets);
+			out.y.reserve(2 * buckets);
+
+			for (size_t b = 0; b < buckets; b++) {
+
+				const size_t start = b * n / buckets;
+				const size_t end = (b + 1) * n / buckets;
+				size_t iMin = start, iMax = start;
+
+				if (y.contiguous()) {
+					// Vectorized min/max, then locate them (the bucket is still in cache)
+					float lo, hi;
+					min_max(y.data + start, end - start, lo, hi);
+					bool foundMin = false, foundMax = false;
+					for (size_t i = start; i < end && !(foundMin && foundMax); i++) {
+						if (!foundMin && y.data[i] == lo) { iMin = i; foundMin = true; }
+						if (!foundMax && y.data[i] == hi) { iMax = i; foundMax = true; }
+					}
+				}
+				else {
+					for (size_t i = start + 1; i < end; i++) {
+						if (y[i] < y[iMin]) { iMin = i; }
+						if (y[i] > y[iMax]) { iMax = i; }
+					}
+				}
+
+				// Keep index order so the line doesn't double back on itself
+				const size_t first = (std::min)(iMin, iMax);
+				const size_t second = (std::max)(iMin, iMax);
+				out.x.push_back(x[first]);
+				out.y.push_back(y[first]);
+				if (second != first) {
+					out.x.push_back(x[second]);
+					out.y.push_back(y[second]);
+				}
+			}
+		}
+
+		/* Largest-Triangle-Three-Buckets (Steinarsson, 2013). First and last points are always kept. */
+		inline void lttb_decimate(const series_view& x, const series_view& y, size_t threshold, Series& out) {
+
+			const size_t n = y.size;
+			if (threshold < 3 || n <= threshold) {
+				copy_series(x, y, out);
+				return;
+			}
+
+			out.x.assign(1, x[0]);
+			out.y.assign(1, y[0]);
+			out.x.reserve(threshold);
+			out.y.reserve(threshold);
+
+			const bool contiguous = x.contiguous() && y.contiguous();
+			const double every = double(n - 2) / double(threshold - 2);
+			size_t a = 0;
+
+			for (size_t b = 0; b < threshold - 2; b++) {
+
+				// Average of the next bucket (the last point for the final bucket)
+				size_t avgStart = static_cast<size_t>((b + 1) * every) + 1;
+				size_t avgEnd = (std::min)(static_cast<size_t>((b + 2) * every) + 1, n);
+				if (avgStart >= avgEnd) {
+					avgStart = n - 1;
+					avgEnd = n;
+				}
+				double avgX = 0.0, avgY = 0.0;
+				if (contiguous) {
+					avgX = sum(x.data + avgStart, avgEnd - avgStart);
+					avgY = sum(y.data + avgStart, avgEnd - avgStart);
+				}
+				else {
+					for (size_t i = avgStart; i < avgEnd; i++) {
+						avgX += x[i];
+						avgY += y[i];
+					}
+				}
+				avgX /= double(avgEnd - avgStart);
+				avgY /= double(avgEnd - avgStart);
+
+				// Current bucket
+				const size_t start = static_cast<size_t>(b * every) + 1;
+				const size_t end = (std::min)(static_cast<size_t>((b + 1) * every) + 1, n - 1);
+
+				// Twice the area of triangle (a, p, avg) expanded to |k0 + kx * px + ky * py|
+				const double ax = x[a], ay = y[a];
+				const float kx = static_cast<float>(avgY - ay);
+				const float ky = static_cast<float>(ax - avgX);
+				const float k0 = static_cast<float>(-(ax - avgX) * ay - ax * (avgY - ay));
+
+				size_t best = start;
+				if (contiguous) {
+					best = start + max_area(x.data + start, y.data + start, end - start, k0, kx, ky);
+				}
+				else {
+					float bestArea = -1.0f;
+					for (size_t i = start; i < end; i++) {
+						const float area = std::fabs(k0 + kx * x[i] + ky * y[i]);
+						if (area > bestArea) {
+							bestArea = area;
+							best = i;
+						}
+					}
+				}
+
+				out.x.push_back(x[best]);
+				out.y.push_back(y[best]);
+				a = best;
+			}
+
+			out.x.push_back(x[n - 1]);
+			out.y.push_back(y[n - 1]);
+		}
+
+		/* Decimate one series with the given settings */
+		inline void decimate(const series_view& x, const series_view& y, const Settings& settings, Series& out) {
+
+			switch (settings.method) {
+			case MIN_MAX:
+				min_max_decimate(x, y, settings.pixels, out);
+				break;
+			case LTTB:
+				lttb_decimate(x, y, settings.pixels, out);
+				break;
+			default:
+				copy_series(x, y, out);
+				break;
+			}
+		}
+
+
+		/* =================================================================================================================
+		Many series (parallel across series)
+		================================================================================================================= */
+
+		/* Each line with its own x coordinates */
+		inline std::vector<Series> decimate(const std::vector<series_view>& x, const std::vector<series_view>& y, const Settings& settings) {
+
+			std::vector<Series> out(y.size());
+			parallel_for(y.size(), settings.threads, [&](size_t j) {
+				decimate(x[j], y[j], settings, out[j]);
+			});
+			return out;
+		}
+
+		/* All lines sharing the same x coordinates */
+		inline std::vector<Series> decimate(const series_view& x, const std::vector<series_view>& y, const Settings& settings) {
+
+			std::vector<Series> out(y.size());
+			parallel_for(y.size(), settings.threads, [&](size_t j) {
+				decimate(x, y[j], settings, out[j]);
+			});
+			return out;
+		}
+
+		/* Views over decimated output, ready to hand to the plotters */
+		inline void views(const std::vector<Series>& series, std::vector<series_view>& x, std::vector<series_view>& y) {
+
+			x.resize(series.size());
+			y.resize(series.size());
+			for (size_t j = 0; j < series.size(); j++) {
+				x[j] = series_view(series[j].x);
+				y[j] = series_view(series[j].y);
+			}
+		}
+
+
+		/* =================================================================================================================
+		Zoom index: full resolution series kept sorted by x with a min/max pyramid over y, so any visible x window can be
+		min/max decimated in O(buckets * (block + levels)) instead of O(visible points).
+		================================================================================================================= */
+		class ZoomIndex {
+
+		public:
+
+			/* Data that is already sorted by x and contiguous is BORROWED (or adopted with TAKE_OWNERSHIP), anything else is
+			   sorted into owned copies (TAKE_OWNERSHIP memory is then freed). Building the pyramid is parallel over blocks. */
+			ZoomIndex(const series_view& x, const series_view& y, Ingestion mode, unsigned threads = 0) : n(y.size), X(nullptr), Y(nullptr) {
+
+				if (x.contiguous() && y.contiguous() && std::is_sorted(x.data, x.data + n)) {
+					if (mode == BORROW) {
+						X = x.data;
+						Y = y.data;
+					}
+					else if (mode == TAKE_OWNERSHIP || mode == TAKE_OWNERSHIP_OF_BLOCK) {
+						adoptedX.reset(const_cast<float*>(x.data));
+						adoptedY.reset(const_cast<float*>(y.data));
+						X = x.data;
+						Y = y.data;
+					}
+				}
+
+				if (X == nullptr) {
+					// Sort by x once (stable so equal x keep their order)
+					std::vector<size_t> order(n);
+					std::iota(order.begin(), order.end(), size_t(0));
+					std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return x[a] < x[b]; });
+
+					ownedX.resize(n);
+					ownedY.resize(n);
+					for (size_t i = 0; i < n; i++) {
+						ownedX[i] = x[order[i]];
+						ownedY[i] = y[order[i]];
+					}
+					X = ownedX.data();
+					Y = ownedY.data();
+
+					// Strided views stay the caller's (see make_float_column)
+					if (x.stride == 1) {
+						release_unwrapped(x, mode);
+					}
+					if (y.stride == 1) {
+						release_unwrapped(y, mode);
+					}
+				}
+
+				build_pyramid(threads);
+			}
+
+			size_t size() const { return n; }
+			const float* x() const { return X; }
+			const float* y() const { return Y; }
+
+			/* Min/max decimation of the points with x in [x0, x1] into "buckets" buckets. One extra point either side of the
+			   window is kept so the line still runs off the edges of the plot. */
+			void query(double x0, double x1, size_t buckets, Series& out) const {
+
+				out.x.clear();
+				out.y.clear();
+				if (n == 0) {
+					return;
+				}
+
+				size_t lo = std::lower_bound(X, X + n, static_cast<float>(x0)) - X;
+				size_t hi = std::upper_bound(X, X + n, static_cast<float>(x1)) - X;
+				if (lo > 0) { lo--; }
+				if (hi < n) { hi++; }
+				const size_t visible = (hi > lo) ? hi - lo : 0;
+
+				if (buckets == 0 || visible <= 2 * buckets) {
+					out.x.assign(X + lo, X + hi);
+					out.y.assign(Y + lo, Y + hi);
+					return;
+				}
+
+				out.x.reserve(2 * buckets);
+				out.y.reserve(2 * buckets);
+				for (size_t b = 0; b < buckets; b++) {
+
+					size_t iMin, iMax;
+					extrema(lo + b * visible / buckets, lo + (b + 1) * visible / buckets, iMin, iMax);
+
+					// Keep index order so the line doesn't double back on itself
+					const size_t first = (std::min)(iMin, iMax);
+					const size_t second = (std::max)(iMin, iMax);
+					out.x.push_back(X[first]);
+					out.y.push_back(Y[first]);
+					if (second != first) {
+						out.x.push_back(X[second]);
+						out.y.push_back(Y[second]);
+					}
+				}
+			}
+
+		private:
+
+			static const size_t block = 64;		// Points per level 0 block. Ranges are scanned raw up to the first/last whole block.
+
+			size_t n;
+			const float* X;
+			const float* Y;
+			std::vector<float> ownedX, ownedY;					// Sorted copies (input was unsorted or strided)
+			std::unique_ptr<float[]> adoptedX, adoptedY;		// TAKE_OWNERSHIP of already sorted input
+			std::vector<std::vector<size_t> > minIdx, maxIdx;	// [level][block] -> index of the min/max y in that block
+
+			void build_pyramid(unsigned threads) {
+
+				// Level 0: whole blocks of raw points (a partial last block is always scanned raw)
+				const size_t blocks = n / block;
+				if (blocks == 0) {
+					return;
+				}
+				minIdx.assign(1, std::vector<size_t>(blocks));
+				maxIdx.assign(1, std::vector<size_t>(blocks));
+
+				const size_t chunk = 4096;	// blocks per parallel work item
+				parallel_for((blocks + chunk - 1) / chunk, threads, [&](size_t c) {
+					const size_t end = (std::min)((c + 1) * chunk, blocks);
+					for (size_t k = c * chunk; k < end; k++) {
+						size_t iMin = k * block, iMax = k * block;
+						for (size_t i = k * block + 1; i < (k + 1) * block; i++) {
+							if (Y[i] < Y[iMin]) { iMin = i; }
+							if (Y[i] > Y[iMax]) { iMax = i; }
+						}
+						minIdx[0][k] = iMin;
+						maxIdx[0][k] = iMax;
+					}
+				});
+
+				// Each level above pairs up the blocks below it (an odd last block has no parent)
+				while (minIdx.back().size() > 1) {
+					const std::vector<size_t>& mn = minIdx.back();
+					const std::vector<size_t>& mx = maxIdx.back();
+					std::vector<size_t> upMin(mn.size() / 2), upMax(mn.size() / 2);
+					for (size_t k = 0; k < upMin.size(); k++) {
+						upMin[k] = (Y[mn[2 * k + 1]] < Y[mn[2 * k]]) ? mn[2 * k + 1] : mn[2 * k];
+						upMax[k] = (Y[mx[2 * k + 1]] > Y[mx[2 * k]]) ? mx[2 * k + 1] : mx[2 * k];
+					}
+					minIdx.push_back(std::move(upMin));
+					maxIdx.push_back(std::move(upMax));
+				}
+			}
+
+			/* Index of the min and max y in [a, b), a < b */
+			void extrema(size_t a, size_t b, size_t& iMin, size_t& iMax) const {
+
+				iMin = a;
+				iMax = a;
+				auto raw = [&](size_t start, size_t end) {
+					for (size_t i = start; i < end; i++) {
+						if (Y[i] < Y[iMin]) { iMin = i; }
+						if (Y[i] > Y[iMax]) { iMax = i; }
+					}
+				};
+
+				// Whole level 0 blocks inside [a, b)
+				size_t A = (a + block - 1) / block;
+				size_t B = b / block;
+				if (minIdx.empty() || A >= B) {
+					raw(a, b);
+					return;
+				}
+				raw(a, A * block);
+				raw(B * block, b);
+
+				// Climb the pyramid: unaligned blocks at the ends are taken at this level, the rest are merged one level up
+				for (size_t level = 0; A < B; level++) {
+					const std::vector<size_t>& mn = minIdx[level];
+					const std::vector<size_t>& mx = maxIdx[level];
+
+					if (level + 1 == minIdx.size() || B - A <= 2) {
+						for (size_t k = A; k < B; k++) {
+							if (Y[mn[k]] < Y[iMin]) { iMin = mn[k]; }
+							if (Y[mx[k]] > Y[iMax]) { iMax = mx[k]; }
+						}
+						break;
+					}
+					if (A & 1) {
+						if (Y[mn[A]] < Y[iMin]) { iMin = mn[A]; }
+						if (Y[mx[A]] > Y[iMax]) { iMax = mx[A]; }
+						A++;
+					}
+					if (B & 1) {
+						if (Y[mn[B - 1]] < Y[iMin]) { iMin = mn[B - 1]; }
+						if (Y[mx[B - 1]] > Y[iMax]) { iMax = mx[B - 1]; }
+						B--;
+					}
+					A /= 2;
+					B /= 2;
+				}
+			}
+		};
+	}
+}
@@ -0,0 +1,379 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------- Figures: long lived view + chart + window that data is swapped into each update -------
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkContextView.h>
+#include <vtkContextScene.h>
+#include <vtkContextItem.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkRenderer.h>
+#include <vtkChartXY.h>
+#include <vtkChartXYZ.h>
+#include <vtkPlot.h>
+#include <vtkPlotPoints.h>
+#include <vtkPlotLine3D.h>
+#include <vtkPlotPoints3D.h>
+#include <vtkTable.h>
+#include <vtkFloatArray.h>
+#include <vtkPen.h>
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_output.h"
+#include "VTK_colours.h"
+#include "VTK_instrumentation.h"
+#include "VTK_2D_plotter.h"
+#include "VTK_3D_plotter.h"
+
+/* External modules */
+#include <vector>
+#include <string>
+#include <memory>
+#include <iostream>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	/* ----- Notes -----:
+	The standalone plotters build a view, chart and render window per call and tear them down again, so re-plotting a
+	dataset every simulation timestep pays the whole set up each time. A Figure keeps all of that alive:
+		_2D::Figure figure("White", true);
+		size_t temperature = figure.add_line("T", x, T);
+		for (each timestep) {
+			solve(T);
+			figure.set_series(temperature, x, T);	// Data copied into the existing collumns (O(1) with BORROW)
+			figure.render();						// One frame
+		}
+		figure.show();								// Interactive loop at the end if wanted (blocks)
+	With a RenderTarget::Png / RenderTarget::Rgba target every render() writes the frame there instead (no display needed).
+	Data is COPIED by default as the figure outlives the call. BORROWED data is not copied but must live until it is replaced
+	by set_series or the figure is destroyed. */
+
+	/* =================================================================================================================
+	What a figure draws on: a vtkContextView for the interactive window, or an Offscreen_scene for headless targets.
+	Both are built once with the figure and re-rendered on demand.
+	================================================================================================================= */
+	class Figure_canvas {
+
+	public:
+
+		Figure_canvas(vtkContextItem* chart, const double background[3], const RenderTarget& target, bool sized) : target(target) {
+
+			if (target.offscreen()) {
+				scene.reset(new Offscreen_scene(chart, background, target));
+				return;
+			}
+
+			view = vtkSmartPointer<vtkContextView>::New();
+			view->GetRenderer()->SetBackground(background);
+			if (sized) {
+				view->GetRenderWindow()->SetSize(target.width, target.height);
+			}
+			view->GetScene()->AddItem(chart);
+		}
+
+		/* Draw one frame (and write it to the target when headless). The window stays open between frames. */
+		bool render() {
+
+			if (scene) {
+				return scene->render(target);
+			}
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
+			view->GetRenderWindow()->Render();
+			return true;
+		}
+
+		/* Hand the window to the interactor until it is closed (interactive targets only) */
+		void show() {
+
+			if (!view) {
+				std::cerr << "W_VTK::Figure: show() needs an interactive (WINDOW) target\n";
+				return;
+			}
+			view->GetRenderWindow()->Render();
+			view->GetInteractor()->Initialize();
+			view->GetInteractor()->Start();
+		}
+
+		/* nullptr for headless targets */
+		vtkContextView* get_view() const { return view; }
+
+	private:
+
+		Figure_canvas(const Figure_canvas&) = delete;
+		Figure_canvas& operator=(const Figure_canvas&) = delete;
+
+		RenderTarget target;
+		vtkSmartPointer<vtkContextView> view;
+		std::unique_ptr<Offscreen_scene> scene;
+	};
+
+
+	namespace _2D {
+
+		/* =================================================================================================================
+		Persistent 2D figure. Each series (line or scatter) gets its own table, so series may have different numbers of points
+		and one can be updated without touching the others. set_series swaps the new data into the series' existing collumns:
+		no new table, plot, chart or window, and only that plot's input is marked modified.
+		================================================================================================================= */
+		class Figure {
+
+		public:
+
+			explicit Figure(const char* BackgroundColour = "White", bool showLegend = false, const RenderTarget& target = RenderTarget())
+				: chart(vtkSmartPointer<vtkChartXY>::New()), autoscale(true) {
+
+				chart->SetShowLegend(showLegend);
+				canvas.reset(new Figure_canvas(chart, named_colours()->GetColor3d(BackgroundColour).GetData(), target, false));
+			}
+
+			/* Add a line, returns its id for set_series. No colour -> next palette colour. */
+			size_t add_line(const std::string& name, series_view x_pos, series_view data, const char* LineColour = nullptr, float width = 1.0f, Ingestion mode = COPY) {
+				return add_series(vtkChart::LINE, name, x_pos, data, LineColour, width, mode);
+			}
+
+			/* Add a scatter dataset, returns its id for set_series. No colour -> next palette colour. */
+			size_t add_scatter(const std::string& name, series_view x_pos, series_view data, const char* PointColour = nullptr, float width = 1.0f, int marker = CIRCLE, Ingestion mode = COPY) {
+
+				const size_t id = add_series(vtkChart::POINTS, name, x_pos, data, PointColour, width, mode);
+				dynamic_cast<vtkPlotPoints*>(series[id].plot)->SetMarkerStyle(marker);
+				return id;
+			}
+
+			/* Swap new data into series "id" (any number of points). The old data is no longer referenced afterwards. */
+			bool set_series(size_t id, series_view x_pos, series_view data, Ingestion mode = COPY) {
+
+				Instrumentation::Scope instrumentation("_2D::Figure::set_series");
+				if (id >= series.size()) {
+					std::cerr << "W_VTK::_2D::Figure: no series " << id << "\n";
+					return false;
+				}
+				if (!series_size_check("Figure::set_series", x_pos.size, data.size, "data")) { return false; }
+
+				Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+				Series& s = series[id];
+				refill_column(s.X, x_pos, mode, s.xWraps);
+				refill_column(s.Y, data, mode, s.yWraps);
+				s.table->Modified();
+				table_timer.stop();
+
+				// New data may be outside the current axes
+				if (autoscale) {
+					Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+					chart->RecalculateBounds();
+				}
+				return true;
+			}
+
+			/* Draw one frame (to the window or the headless target) */
+			bool render() {
+
+				Instrumentation::Scope instrumentation("_2D::Figure::render");
+				return canvas->render();
+			}
+
+			/* Interactive loop (blocks until the window is closed) */
+			void show() { canvas->show(); }
+
+			/* Rescale the axes to the data on every set_series (default on) */
+			void set_autoscale(bool on) { autoscale = on; }
+
+			size_t size() const { return series.size(); }
+			vtkChartXY* get_chart() const { return chart; }
+			vtkPlot* get_plot(size_t id) const { return (id < series.size()) ? series[id].plot : nullptr; }
+			vtkContextView* get_view() const { return canvas->get_view(); }
+
+		private:
+
+			Figure(const Figure&) = delete;
+			Figure& operator=(const Figure&) = delete;
+
+			struct Series {
+				vtkPlot* plot;							// Owned by the chart
+				vtkSmartPointer<vtkTable> table;
+				vtkSmartPointer<vtkFloatArray> X, Y;
+				bool xWraps, yWraps;					// Collumn wraps memory it didn't allocate (see refill_column)
+			};
+
+			size_t add_series(int plotType, const std::string& name, const series_view& x_pos, const series_view& data, const char* colour, float width, Ingestion mode) {
+
+				Instrumentation::Scope instrumentation("_2D::Figure::add_series");
+				// Mismatched sizes are reported and the series starts empty (set_series can still fill it)
+				if (!series_size_check("Figure::add_series", x_pos.size, data.size, name.c_str())) {
+					return add_series(plotType, name, series_view(), series_view(), colour, width, COPY);
+				}
+
+				// Table per series: col 0 -> x, col 1 -> data. NAMES MATTER, see Line_plotter.
+				Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+				Series s;
+				s.table = vtkSmartPointer<vtkTable>::New();
+				s.X = make_float_column(("X: " + name).c_str(), x_pos, mode);
+				s.Y = make_float_column(name.c_str(), data, mode);
+				s.xWraps = x_pos.contiguous() && mode != COPY;
+				s.yWraps = data.contiguous() && mode != COPY;
+				s.table->AddColumn(s.X);
+				s.table->AddColumn(s.Y);
+				table_timer.stop();
+
+				Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+				s.plot = chart->AddPlot(plotType);
+				s.plot->SetInputData(s.table, 0, 1);
+				if (colour) {
+					s.plot->GetPen()->SetColorF(named_colours()->GetColor3d(colour).GetData());
+				}
+				else {
+					s.plot->GetPen()->SetColorF(palette.next().GetData());
+				}
+				s.plot->SetWidth(width);
+
+				series.push_back(s);
+				return series.size() - 1;
+			}
+
+			vtkSmartPointer<vtkChartXY> chart;
+			Palette palette;
+			bool autoscale;
+			std::vector<Series> series;
+			std::unique_ptr<Figure_canvas> canvas;		// After the chart it draws
+		};
+	}
+
+
+	namespace _3D {
+
+		/* =================================================================================================================
+		Persistent 3D figure. As the 2D figure, but note vtkPlot3D copies its table into its own point list when its input is
+		set, so on top of the collumn swap set_series pays one pass over the series' points inside VTK.
+		================================================================================================================= */
+		class Figure {
+
+		public:
+
+			explicit Figure(const char* BackgroundColour = "White", const RenderTarget& target = RenderTarget())
+				: chart(vtkSmartPointer<vtkChartXYZ>::New()), autoscale(true) {
+
+				// Axes box inside the window (offscreen scenes size it to their image)
+				chart->SetGeometry(vtkRectf(5.0f, 5.0f, target.width - 5.0f, target.height - 5.0f));
+				canvas.reset(new Figure_canvas(chart, named_colours()->GetColor3d(BackgroundColour).GetData(), target, true));
+			}
+
+			/* Add a 3D line, returns its id for set_series. No colour -> next palette colour. */
+			size_t add_line(series_view x, series_view y, series_view z, const char* LineColourName = nullptr, float width = 1.0f, Ingestion mode = COPY) {
+				return add_series(vtkSmartPointer<vtkPlotLine3D>::New(), x, y, z, LineColourName, width, mode);
+			}
+
+			/* Add a 3D scatter dataset, returns its id for set_series. No colour -> next palette colour. */
+			size_t add_scatter(series_view x, series_view y, series_view z, const char* PointColourName = nullptr, float width = 1.0f, Ingestion mode = COPY) {
+				return add_series(vtkSmartPointer<vtkPlotPoints3D>::New(), x, y, z, PointColourName, width, mode);
+			}
+
+			/* Swap new data into series "id" (any number of points) */
+			bool set_series(size_t id, series_view x, series_view y, series_view z, Ingestion mode = COPY) {
+
+				Instrumentation::Scope instrumentation("_3D::Figure::set_series");
+				if (id >= series.size()) {
+					std::cerr << "W_VTK::_3D::Figure: no series " << id << "\n";
+					return false;
+				}
+				if (!axis_size_check(x, y, z)) { return false; }
+
+				Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+				Series& s = series[id];
+				const series_view axes[spatial_dimensions] = { x, y, z };
+				for (int axis = 0; axis < spatial_dimensions; axis++) {
+					refill_column(s.columns[axis], axes[axis], block_row_mode(mode, axis), s.wraps[axis]);
+				}
+				s.table->Modified();
+				table_timer.stop();
+
+				// vtkPlot3D only reads its input here
+				Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+				s.plot->SetInputData(s.table);
+				if (autoscale) {
+					chart->RecalculateBounds();
+				}
+				return true;
+			}
+
+			/* Draw one frame (to the window or the headless target) */
+			bool render() {
+
+				Instrumentation::Scope instrumentation("_3D::Figure::render");
+				return canvas->render();
+			}
+
+			/* Interactive loop (blocks until the window is closed) */
+			void show() { canvas->show(); }
+
+			/* Rescale the axes to the data on every set_series (default on) */
+			void set_autoscale(bool on) { autoscale = on; }
+
+			size_t size() const { return series.size(); }
+			vtkChartXYZ* get_chart() const { return chart; }
+			vtkPlot3D* get_plot(size_t id) const { return (id < series.size()) ? series[id].plot.GetPointer() : nullptr; }
+			vtkContextView* get_view() const { return canvas->get_view(); }
+
+		private:
+
+			Figure(const Figure&) = delete;
+			Figure& operator=(const Figure&) = delete;
+
+			struct Series {
+				vtkSmartPointer<vtkPlot3D> plot;
+				vtkSmartPointer<vtkTable> table;
+				vtkSmartPointer<vtkFloatArray> columns[spatial_dimensions];
+				bool wraps[spatial_dimensions];			// Collumn wraps memory it didn't allocate (see refill_column)
+			};
+
+			size_t add_series(vtkSmartPointer<vtkPlot3D> plot, const series_view& x, const series_view& y, const series_view& z, const char* colour, float width, Ingestion mode) {
+
+				Instrumentation::Scope instrumentation("_3D::Figure::add_series");
+
+				// Mismatched sizes are reported and the series starts empty (set_series can still fill it)
+				if (!axis_size_check(x, y, z)) {
+					return add_series(plot, series_view(), series_view(), series_view(), colour, width, COPY);
+				}
+
+				// X -> col 0; Y -> col 1; Z -> col 2
+				Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+				Series s;
+				s.plot = plot;
+				s.table = vtkSmartPointer<vtkTable>::New();
+				const char* names[spatial_dimensions] = { "X", "Y", "Z" };
+				const series_view axes[spatial_dimensions] = { x, y, z };
+				for (int axis = 0; axis < spatial_dimensions; axis++) {
+					s.columns[axis] = make_float_column(names[axis], axes[axis], block_row_mode(mode, axis));
+					s.wraps[axis] = axes[axis].contiguous() && mode != COPY;
+					s.table->AddColumn(s.columns[axis]);
+				}
+				table_timer.stop();
+
+				Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+				s.plot->SetInputData(s.table);
+				if (colour) {
+					s.plot->GetPen()->SetColorF(named_colours()->GetColor3d(colour).GetData());
+				}
+				else {
+					s.plot->GetPen()->SetColorF(palette.next().GetData());
+				}
+				s.plot->GetPen()->SetWidth(width);
+				chart->AddPlot(s.plot);
+
+				series.push_back(s);
+				return series.size() - 1;
+			}
+
+			vtkSmartPointer<vtkChartXYZ> chart;
+			Palette palette;
+			bool autoscale;
+			std::vector<Series> series;
+			std::unique_ptr<Figure_canvas> canvas;		// After the chart it draws
+		};
+	}
+}
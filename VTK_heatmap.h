@@ -0,0 +1,502 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------ Heatmaps: 2D scalar fields wrapped as vtkImageData and drawn as one coloured image ----
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkChartXY.h>
+#include <vtkPlot.h>
+#include <vtkBrush.h>
+#include <vtkContext2D.h>
+#include <vtkContextView.h>
+#include <vtkContextScene.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkStringArray.h>
+#include <vtkRect.h>
+#include <vtkVector.h>
+#include <vtkStdString.h>
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_output.h"
+#include "VTK_colours.h"
+#include "VTK_instrumentation.h"
+#include "VTK_parallel.h"
+#include "VTK_2D_plotter.h"
+
+/* External modules */
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	namespace _2D {
+
+		/* ----- Notes -----:
+		A field flattened into scatter points is 3 floats per cell plus a marker per cell to draw. Heatmap_plot is ONE vtkPlot
+		over the grid as it is:
+			grid		-> rows * cols values, row major (row 0 is the bottom of the plot, x runs along a row), any series_view
+						   value type. BORROW / TAKE_OWNERSHIP wrap the memory as the vtkImageData's scalars (no copy, see
+						   GetImage for VTK filters or a vtkChartHistogram2D), COPY and strided grids are copied once. SetData
+						   and the chart variant COPY by default (the plot outlives the call), the standalone plotters BORROW.
+			colours		-> value -> index into a 256 entry colour map table in a branch free loop per row (the table read
+						   aside it vectorises), rows spread over threads. NaN and infinite cells are transparent.
+			image		-> the coloured image is at most max_image_size per side: bigger grids are sampled (nearest cell) so
+						   a 4096 x 4096 field is coloured at screen size and drawn with one DrawImage. It is only recoloured
+						   when the data, range or colour map change, so panning and zooming redraw the cached image.
+			range		-> min / max of the finite values (parallel scan) unless set with SetRange
+			tooltip		-> the cell under the mouse and its value (O(1))
+		extent -> the data coordinates the grid covers: x0 .. x1 along a row, y0 .. y1 over the rows (default the cell indices). */
+
+		class Heatmap_plot : public vtkPlot {
+
+		public:
+
+			static Heatmap_plot* New() {
+				Heatmap_plot* plot = new Heatmap_plot;
+				plot->InitializeObjectBase();
+				return plot;
+			}
+
+			/* Hand over the grid: rows * cols values, row after row. TAKE_OWNERSHIP memory is freed with the plot. */
+			bool SetData(const std::string& name, series_view grid, size_t rows, size_t cols, Ingestion mode = COPY, unsigned threads = 0) {
+
+				if (!series_size_check("Heatmap_plot", rows * cols, grid.size, name.c_str())) { return false; }
+
+				Name = name;
+				Rows = rows;
+				Cols = cols;
+				Threads = threads;
+
+				// The grid becomes the image's scalars (wrapped, or copied by make_column into memory of its own)
+				vtkSmartPointer<vtkDataArray> scalars = make_column(name.c_str(), grid, mode);
+				Image = vtkSmartPointer<vtkImageData>::New();
+				Image->SetDimensions(static_cast<int>(cols), static_cast<int>(rows), 1);
+				Image->GetPointData()->SetScalars(scalars);
+
+				Grid = grid;
+				if (mode == COPY || grid.stride != 1) {
+					Grid.values = scalars->GetVoidPointer(0);
+					Grid.data = (grid.type == FLOAT32) ? static_cast<const float*>(Grid.values) : nullptr;
+					Grid.stride = 1;
+				}
+
+				if (!Extent) {
+					SetExtent(0.0, static_cast<double>(cols), 0.0, static_cast<double>(rows));
+					Extent = false;
+				}
+				if (AutoRange) {
+					ScanRange();
+				}
+				ImageDirty = true;
+				LabelsDirty = true;
+				this->Modified();
+				return true;
+			}
+
+			/* Data coordinates covered by the grid (x0 .. x1 along a row, y0 .. y1 over the rows) */
+			void SetExtent(double x0, double x1, double y0, double y1) {
+				Bounds[0] = x0;
+				Bounds[1] = x1;
+				Bounds[2] = y0;
+				Bounds[3] = y1;
+				Extent = true;
+				this->Modified();
+			}
+
+			/* Values mapped to the ends of the colour map (outside -> clamped). SetAutoRange goes back to the data's min / max. */
+			void SetRange(double lo, double hi) {
+				Range[0] = lo;
+				Range[1] = hi;
+				AutoRange = false;
+				ImageDirty = true;
+				LabelsDirty = true;
+				this->Modified();
+			}
+
+			void SetAutoRange() {
+				AutoRange = true;
+				ScanRange();
+				ImageDirty = true;
+				LabelsDirty = true;
+				this->Modified();
+			}
+
+			const double* GetRange() const { return Range; }
+
+			void SetColourMap(Colour_map map, double opacity = 1.0) {
+				const unsigned char alpha = static_cast<unsigned char>((std::min)((std::max)(opacity, 0.0), 1.0) * 255.0 + 0.5);
+				colour_map_table(map, Table, alpha);
+				std::memset(Table[256], 0, 4);		// NaN / inf
+				ImageDirty = true;
+				this->Modified();
+			}
+
+			/* Largest coloured image side (0 -> one pixel per cell) */
+			void SetMaxImageSize(size_t pixels) {
+				MaxImageSize = pixels;
+				ImageDirty = true;
+				this->Modified();
+			}
+
+			/* The grid's values changed in place (e.g. a solver writing into borrowed memory) */
+			void DataChanged() {
+				if (Image) {
+					Image->GetPointData()->GetScalars()->Modified();
+					Image->Modified();
+				}
+				if (AutoRange) {
+					ScanRange();
+				}
+				ImageDirty = true;
+				LabelsDirty = true;
+				this->Modified();
+			}
+
+			/* The grid as VTK scalars (zero copy when borrowed) */
+			vtkImageData* GetImage() const { return Image; }
+
+			/* ----- vtkPlot -----: */
+
+			void Update() override {
+				UpdateImage();
+			}
+
+			bool Paint(vtkContext2D* painter) override {
+
+				UpdateImage();
+				if (Pixels.empty()) {
+					return true;
+				}
+
+				const vtkRectd shift_scale = this->ShiftScale;
+				const float x = static_cast<float>((Bounds[0] + shift_scale.GetX()) * shift_scale.GetWidth());
+				const float y = static_cast<float>((Bounds[2] + shift_scale.GetY()) * shift_scale.GetHeight());
+				const float width = static_cast<float>((Bounds[1] - Bounds[0]) * shift_scale.GetWidth());
+				const float height = static_cast<float>((Bounds[3] - Bounds[2]) * shift_scale.GetHeight());
+				painter->DrawImage(vtkRectf(x, y, width, height), Coloured);
+				return true;
+			}
+
+			/* The colour map as a strip of swatches, low to high */
+			bool PaintLegend(vtkContext2D* painter, const vtkRectf& rect, int) override {
+
+				const int steps = 16;
+				const float step = rect.GetWidth() / steps;
+				painter->ApplyPen(this->Pen);
+				for (int s = 0; s < steps; s++) {
+					const unsigned char* colour = Table[(s * 255) / (steps - 1)];
+					painter->GetBrush()->SetColor(colour[0], colour[1], colour[2], 255);
+					painter->DrawRect(rect.GetX() + s * step, rect.GetY(), step, rect.GetHeight());
+				}
+				return true;
+			}
+
+			/* "name (lo .. hi)" */
+			vtkStringArray* GetLabels() override {
+
+				if (LabelsDirty) {
+					std::ostringstream label;
+					label << Name << " (" << Range[0] << " .. " << Range[1] << ")";
+					Legend->SetNumberOfValues(1);
+					Legend->SetValue(0, label.str().c_str());
+					LabelsDirty = false;
+				}
+				return Legend;
+			}
+
+			/* Bounds of the grid as the chart draws it (shifted/scaled) and as it was given */
+			void GetBounds(double bounds[4]) override {
+
+				const vtkRectd shift_scale = this->ShiftScale;
+				bounds[0] = (Bounds[0] + shift_scale.GetX()) * shift_scale.GetWidth();
+				bounds[1] = (Bounds[1] + shift_scale.GetX()) * shift_scale.GetWidth();
+				bounds[2] = (Bounds[2] + shift_scale.GetY()) * shift_scale.GetHeight();
+				bounds[3] = (Bounds[3] + shift_scale.GetY()) * shift_scale.GetHeight();
+			}
+
+			void GetUnscaledInputBounds(double bounds[4]) override {
+				std::memcpy(bounds, Bounds, sizeof(Bounds));
+			}
+
+			/* Cell under "point" (plot coordinates): returns its index (row * cols + col), location is the cell centre */
+			vtkIdType GetNearestPoint(const vtkVector2f& point, const vtkVector2f&, vtkVector2f* location, vtkIdType* segmentId) override {
+
+				const vtkRectd shift_scale = this->ShiftScale;
+				if (Grid.size == 0 || shift_scale.GetWidth() == 0.0 || shift_scale.GetHeight() == 0.0 || Bounds[1] == Bounds[0] || Bounds[3] == Bounds[2]) {
+					return -1;
+				}
+
+				// Back to data coordinates, then to a cell
+				const double px = point.GetX() / shift_scale.GetWidth() - shift_scale.GetX();
+				const double py = point.GetY() / shift_scale.GetHeight() - shift_scale.GetY();
+				const double col = std::floor((px - Bounds[0]) / (Bounds[1] - Bounds[0]) * Cols);
+				const double row = std::floor((py - Bounds[2]) / (Bounds[3] - Bounds[2]) * Rows);
+				if (col < 0.0 || row < 0.0 || col >= Cols || row >= Rows) {
+					return -1;
+				}
+
+				const double cx = Bounds[0] + (col + 0.5) * (Bounds[1] - Bounds[0]) / Cols;
+				const double cy = Bounds[2] + (row + 0.5) * (Bounds[3] - Bounds[2]) / Rows;
+				*location = vtkVector2f(static_cast<float>((cx + shift_scale.GetX()) * shift_scale.GetWidth()),
+										static_cast<float>((cy + shift_scale.GetY()) * shift_scale.GetHeight()));
+				*segmentId = 0;
+				return static_cast<vtkIdType>(row) * static_cast<vtkIdType>(Cols) + static_cast<vtkIdType>(col);
+			}
+
+			/* Cell centre (data coordinates) and its value */
+			vtkStdString GetTooltipLabel(const vtkVector2d& plotPos, vtkIdType seriesIndex, vtkIdType) override {
+
+				std::ostringstream label;
+				label << Name << " (" << plotPos.GetX() << ", " << plotPos.GetY() << ")";
+				if (seriesIndex >= 0 && static_cast<size_t>(seriesIndex) < Grid.size) {
+					label << ": " << Grid[static_cast<size_t>(seriesIndex)];
+				}
+				return label.str();
+			}
+
+		protected:
+
+			Heatmap_plot() : Rows(0), Cols(0), MaxImageSize(2048), Threads(0), Extent(false), AutoRange(true), ImageDirty(true), LabelsDirty(true),
+				Legend(vtkSmartPointer<vtkStringArray>::New()), Coloured(vtkSmartPointer<vtkImageData>::New()), ColouredScalars(vtkSmartPointer<vtkUnsignedCharArray>::New()) {
+
+				std::memset(Bounds, 0, sizeof(Bounds));
+				Range[0] = 0.0;
+				Range[1] = 1.0;
+				SetColourMap(VIRIDIS);
+				ColouredScalars->SetNumberOfComponents(4);
+				this->SetSelectable(false);
+			}
+
+		private:
+
+			Heatmap_plot(const Heatmap_plot&) = delete;
+			void operator=(const Heatmap_plot&) = delete;
+
+			/* Min / max of the finite values, rows in parallel then reduced */
+			void ScanRange() {
+
+				const size_t chunk = 64;
+				const size_t chunks = (Rows + chunk - 1) / chunk;
+				std::vector<double> lo(chunks, 0.0), hi(chunks, 0.0);
+				std::vector<char> filled(chunks, 0);
+
+				parallel_for(chunks, Threads, [&](size_t c) {
+					const size_t first = c * chunk * Cols;
+					const size_t count = ((std::min)(Rows, (c + 1) * chunk) - c * chunk) * Cols;
+					switch (Grid.type) {
+					case FLOAT64:	filled[c] = min_max(static_cast<const double*>(Grid.values) + first, count, lo[c], hi[c]); break;
+					case INT32:		filled[c] = min_max(static_cast<const int32_t*>(Grid.values) + first, count, lo[c], hi[c]); break;
+					case INT16:		filled[c] = min_max(static_cast<const int16_t*>(Grid.values) + first, count, lo[c], hi[c]); break;
+					case UINT8:		filled[c] = min_max(static_cast<const uint8_t*>(Grid.values) + first, count, lo[c], hi[c]); break;
+					default:		filled[c] = min_max(Grid.data + first, count, lo[c], hi[c]); break;
+					}
+				});
+
+				bool first = true;
+				Range[0] = 0.0;
+				Range[1] = 1.0;
+				for (size_t c = 0; c < chunks; c++) {
+					if (filled[c]) {
+						Range[0] = first ? lo[c] : (std::min)(Range[0], lo[c]);
+						Range[1] = first ? hi[c] : (std::max)(Range[1], hi[c]);
+						first = false;
+					}
+				}
+			}
+
+			/* NaN and inf are skipped (an infinite bound would leave no scale). False when there is no finite value. */
+			template<typename T>
+			static char min_max(const T* values, size_t count, double& lo, double& hi) {
+
+				T low = T(), high = T();
+				size_t i = 0;
+				while (i < count && !std::isfinite(static_cast<double>(values[i]))) {
+					i++;
+				}
+				if (i == count) {
+					return 0;
+				}
+				low = high = values[i];
+				for (; i < count; i++) {
+					if (std::isfinite(static_cast<double>(values[i]))) {
+						low = (values[i] < low) ? values[i] : low;
+						high = (values[i] > high) ? values[i] : high;
+					}
+				}
+				lo = static_cast<double>(low);
+				hi = static_cast<double>(high);
+				return 1;
+			}
+
+			/* Colour map slot of one value: non-finite values (and a scale that overflowed to NaN) -> the transparent slot 256 */
+			static int Slot(float v, float lo, float scale) {
+				const float t = (std::min)((std::max)((v - lo) * scale, 0.0f), 255.0f);
+				return (std::isfinite(v) && t == t) ? static_cast<int>(t) : 256;
+			}
+
+			/* Colour one image row: values[columns[i]] (or values[i] when every column is used) -> RGBA */
+			template<typename T>
+			void ColourRow(const T* values, const std::vector<size_t>& columns, unsigned char* out) const {
+
+				const float lo = static_cast<float>(Range[0]);
+				const float scale = (Range[1] > Range[0]) ? static_cast<float>(256.0 / (Range[1] - Range[0])) : 0.0f;
+				const size_t width = columns.empty() ? Cols : columns.size();
+
+				if (columns.empty()) {
+					for (size_t i = 0; i < width; i++) {
+						std::memcpy(out + 4 * i, Table[Slot(static_cast<float>(values[i]), lo, scale)], 4);
+					}
+				}
+				else {
+					for (size_t i = 0; i < width; i++) {
+						std::memcpy(out + 4 * i, Table[Slot(static_cast<float>(values[columns[i]]), lo, scale)], 4);
+					}
+				}
+			}
+
+			/* Recolour the (possibly sampled) image when something changed */
+			void UpdateImage() {
+
+				if (!ImageDirty || Grid.size == 0) {
+					return;
+				}
+				ImageDirty = false;
+
+				// Nearest cell sampling down to MaxImageSize per side (centre of each pixel's span of cells)
+				const size_t width = (MaxImageSize > 0 && Cols > MaxImageSize) ? MaxImageSize : Cols;
+				const size_t height = (MaxImageSize > 0 && Rows > MaxImageSize) ? MaxImageSize : Rows;
+				std::vector<size_t> columns;
+				if (width < Cols) {
+					columns.resize(width);
+					for (size_t i = 0; i < width; i++) {
+						columns[i] = ((2 * i + 1) * Cols) / (2 * width);
+					}
+				}
+
+				Pixels.resize(4 * width * height);
+				parallel_for((height + 15) / 16, Threads, [&](size_t block) {
+					for (size_t j = block * 16; j < height && j < (block + 1) * 16; j++) {
+						const size_t row = (height < Rows) ? ((2 * j + 1) * Rows) / (2 * height) : j;
+						unsigned char* out = Pixels.data() + 4 * width * j;
+						switch (Grid.type) {
+						case FLOAT64:	ColourRow(static_cast<const double*>(Grid.values) + row * Cols, columns, out); break;
+						case INT32:		ColourRow(static_cast<const int32_t*>(Grid.values) + row * Cols, columns, out); break;
+						case INT16:		ColourRow(static_cast<const int16_t*>(Grid.values) + row * Cols, columns, out); break;
+						case UINT8:		ColourRow(static_cast<const uint8_t*>(Grid.values) + row * Cols, columns, out); break;
+						default:		ColourRow(Grid.data + row * Cols, columns, out); break;
+						}
+					}
+				});
+
+				// The image wraps Pixels (rows bottom to top, as DrawImage expects)
+				ColouredScalars->SetArray(Pixels.data(), static_cast<vtkIdType>(Pixels.size()), 1);
+				Coloured->SetDimensions(static_cast<int>(width), static_cast<int>(height), 1);
+				Coloured->GetPointData()->SetScalars(ColouredScalars);
+				Coloured->Modified();
+			}
+
+			std::string Name;
+			series_view Grid;							// Contiguous view of the image's scalars
+			size_t Rows, Cols;
+			double Bounds[4];							// Extent
+			double Range[2];
+			unsigned char Table[257][4];				// Colour map + transparent for NaN / inf
+			std::vector<unsigned char> Pixels;			// Coloured image (RGBA)
+			size_t MaxImageSize;
+			unsigned Threads;
+			bool Extent, AutoRange, ImageDirty, LabelsDirty;
+			vtkSmartPointer<vtkStringArray> Legend;
+			vtkSmartPointer<vtkImageData> Image;		// The grid as scalars
+			vtkSmartPointer<vtkImageData> Coloured;
+			vtkSmartPointer<vtkUnsignedCharArray> ColouredScalars;
+		};
+
+		/* =================================================================================================================
+		Plot a rows x cols grid (row major, row 0 at the bottom) as a heatmap covering x0 .. x1, y0 .. y1.
+		False when the grid is rejected (see std::cerr) or the headless image isn't written.
+		=================================================================================================================== */
+		inline bool Heatmap_plotter(const std::string& name, series_view grid, size_t rows, size_t cols, double x0, double x1, double y0, double y1, Colour_map map = VIRIDIS, Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
+
+			Instrumentation::Scope instrumentation("_2D::Heatmap_plotter");
+
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+			vtkSmartPointer<Heatmap_plot> heatmap = vtkSmartPointer<Heatmap_plot>::New();
+			heatmap->SetExtent(x0, x1, y0, y1);
+			if (!heatmap->SetData(name, grid, rows, cols, mode)) { return false; }
+			table_timer.stop();
+
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+			heatmap->SetColourMap(map);
+
+			vtkSmartPointer<vtkChartXY> chart = vtkSmartPointer<vtkChartXY>::New();
+			chart->SetShowLegend(true);
+			chart->AddPlot(heatmap);
+			layout.stop();
+			Instrumentation::update_measured(chart.GetPointer());
+
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(chart, default_background, target);
+			}
+
+			// Set up the view
+			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
+			view->GetRenderer()->SetBackground(1.0, 1.0, 1.0);
+			view->GetScene()->AddItem(chart);
+
+			// Start interactor and render window
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
+			view->GetRenderWindow()->Render();
+			render_timer.stop();
+			instrumentation.finish();
+			view->GetInteractor()->Initialize();
+			view->GetInteractor()->Start();
+			return true;
+		}
+
+		/* Cell indices as the axes */
+		inline bool Heatmap_plotter(const std::string& name, series_view grid, size_t rows, size_t cols, Colour_map map = VIRIDIS, Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
+			return Heatmap_plotter(name, grid, rows, cols, 0.0, static_cast<double>(cols), 0.0, static_cast<double>(rows), map, mode, target);
+		}
+
+		/* =================================================================================================================
+		Heatmap creator which adds the grid as one plot to the inputted chart (see multiplot_chart_instantiation)
+		================================================================================================================= */
+		inline void Heatmap_plotter(vtkSmartPointer<vtkChartXY>& chart, const std::string& name, series_view grid, size_t rows, size_t cols, double x0, double x1, double y0, double y1, Colour_map map = VIRIDIS, Ingestion mode = COPY) {
+
+			Instrumentation::Scope instrumentation("_2D::Heatmap_plotter");
+
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+			vtkSmartPointer<Heatmap_plot> heatmap = vtkSmartPointer<Heatmap_plot>::New();
+			heatmap->SetExtent(x0, x1, y0, y1);
+			if (!heatmap->SetData(name, grid, rows, cols, mode)) { return; }
+			table_timer.stop();
+
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+			heatmap->SetColourMap(map);
+			chart->AddPlot(heatmap);
+		}
+
+		/* grid[rows][cols] as it is (no copy with BORROW). TAKE_OWNERSHIP means ownership of the whole block. */
+		template<int rows, int cols, typename T>
+		void Heatmap_plotter(const std::string& name, T(&grid)[rows][cols], Colour_map map = VIRIDIS, Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
+			Heatmap_plotter(name, series_view(&grid[0][0], static_cast<size_t>(rows) * cols), rows, cols, map, as_block(mode), target);
+		}
+	}
+}
@@ -0,0 +1,519 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------ Histograms: samples binned in parallel (SIMD) and drawn as one bar plot ---------------
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkChart.h>
+#include <vtkChartXY.h>
+#include <vtkPlot.h>
+#include <vtkAxis.h>
+#include <vtkTable.h>
+#include <vtkPen.h>
+#include <vtkBrush.h>
+#include <vtkDoubleArray.h>
+#include <vtkStringArray.h>
+#include <vtkContextView.h>
+#include <vtkContextScene.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_output.h"
+#include "VTK_colours.h"
+#include "VTK_instrumentation.h"
+#include "VTK_parallel.h"
+#include "VTK_decimation.h"		// W_VTK_SSE2
+#include "VTK_2D_plotter.h"
+
+/* External modules */
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <cstdint>
+#include <cmath>
+#include <cfloat>
+#include <limits>
+#include <algorithm>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	namespace Histogram {
+
+		/* ----- Notes -----:
+		100M samples as scatter points are 100M markers for VTK to cache and draw, to show what a few hundred bars show. Here
+		the samples are binned first and only the bars go to VTK:
+			slices	-> the samples are split into one contiguous slice per worker thread. Each worker counts into its own
+					   partial histogram (4 interleaved copies, so runs of the same bin don't wait on each other's stores)
+					   and the partials are summed at the end: no atomics and nothing shared while counting.
+			binning	-> 4 samples at a time (SSE2): bin = (value - lo) * bins / (hi - lo), for LOG bins from a fast log2
+					   (exponent bits + a cubic of the mantissa), clamped and converted in vector registers. Each bin is then
+					   checked against its edges and moved over if the float maths put it next to the right one, so the
+					   counts match the edges exactly. Bins are [edge i, edge i + 1), the last one includes hi.
+			types	-> contiguous float is read in place, other value types and strided views are converted to float one
+					   64k chunk at a time (per worker, so memory use doesn't grow with the data)
+			range	-> lo / hi from Settings, or (lo >= hi) the min / max of the finite samples (the positive ones for LOG),
+					   found in an extra vectorized pass
+		Samples outside the range are counted in below / above (for LOG zero and negative samples are below), NaNs in
+		invalid. None of them are drawn. bin() gives the counts on their own, _2D::Histogram_plotter draws them. */
+
+		enum Scale {
+			LINEAR, LOG
+		};
+
+		/* Histogram settings passed to bin / _2D::Histogram_plotter */
+		struct Settings {
+
+			size_t bins;
+			Scale scale;		// LINEAR -> bins of equal width, LOG -> equal width in log(value) (edges grow by a constant factor)
+			double lo, hi;		// Range binned, lo >= hi (the default) -> the samples' own
+			unsigned threads;	// Worker threads (0 -> one per hardware thread)
+
+			Settings(size_t bins = 100, Scale scale = LINEAR, double lo = 0.0, double hi = 0.0, unsigned threads = 0)
+				: bins(bins), scale(scale), lo(lo), hi(hi), threads(threads) {}
+
+			bool auto_range() const { return !(lo < hi); }
+		};
+
+		/* The counts of one histogram */
+		struct Bins {
+
+			Scale scale;
+			std::vector<double> edges;			// bins + 1 edges
+			std::vector<uint64_t> counts;		// One per bin
+			uint64_t below, above, invalid;		// Samples outside the edges and NaNs (not in counts)
+
+			Bins() : scale(LINEAR), below(0), above(0), invalid(0) {}
+
+			size_t size() const { return counts.size(); }
+
+			/* Samples in the bins */
+			uint64_t binned() const {
+				uint64_t total = 0;
+				for (uint64_t count : counts) {
+					total += count;
+				}
+				return total;
+			}
+		};
+
+		/* Samples handed to a worker at a time (and the size of the conversion buffer for non float data) */
+		const size_t chunk_size = 1 << 16;
+
+		template<typename T>
+		void convert(const T* p, ptrdiff_t stride, size_t n, float* out) {
+			for (size_t i = 0; i < n; i++) {
+				out[i] = static_cast<float>(p[static_cast<ptrdiff_t>(i) * stride]);
+			}
+		}
+
+		/* Samples [first, first + n) as contiguous floats: the data itself when it already is, otherwise converted into buffer */
+		inline const float* float_chunk(const series_view& view, size_t first, size_t n, std::vector<float>& buffer) {
+
+			if (view.contiguous()) {
+				return view.data + first;
+			}
+
+			buffer.resize(n);
+			const ptrdiff_t offset = static_cast<ptrdiff_t>(first) * view.stride;
+			switch (view.type) {
+			case FLOAT64:	convert(static_cast<const double*>(view.values) + offset, view.stride, n, buffer.data()); break;
+			case INT32:		convert(static_cast<const int32_t*>(view.values) + offset, view.stride, n, buffer.data()); break;
+			case INT16:		convert(static_cast<const int16_t*>(view.values) + offset, view.stride, n, buffer.data()); break;
+			case UINT8:		convert(static_cast<const uint8_t*>(view.values) + offset, view.stride, n, buffer.data()); break;
+			default:		convert(view.data + offset, view.stride, n, buffer.data()); break;
+			}
+			return buffer.data();
+		}
+
+		/* Min and max of the samples in [floor, FLT_MAX] (NaN and inf never are). lo > hi when there are none. */
+		inline void finite_range(const float* p, size_t n, float floor, float& lo, float& hi) {
+
+			size_t i = 0;
+			lo = std::numeric_limits<float>::infinity();
+			hi = -lo;
+#if defined(W_VTK_SSE2)
+			if (n >= 4) {
+				const __m128 low = _mm_set1_ps(floor), top = _mm_set1_ps(FLT_MAX);
+				const __m128 none_lo = _mm_set1_ps(lo), none_hi = _mm_set1_ps(hi);
+				__m128 l = none_lo, h = none_hi;
+				for (; i + 4 <= n; i += 4) {
+					const __m128 v = _mm_loadu_ps(p + i);
+					const __m128 ok = _mm_and_ps(_mm_cmpge_ps(v, low), _mm_cmple_ps(v, top));
+					l = _mm_min_ps(l, _mm_or_ps(_mm_and_ps(ok, v), _mm_andnot_ps(ok, none_lo)));
+					h = _mm_max_ps(h, _mm_or_ps(_mm_and_ps(ok, v), _mm_andnot_ps(ok, none_hi)));
+				}
+				float ls[4], hs[4];
+				_mm_storeu_ps(ls, l);
+				_mm_storeu_ps(hs, h);
+				lo = (std::min)((std::min)(ls[0], ls[1]), (std::min)(ls[2], ls[3]));
+				hi = (std::max)((std::max)(hs[0], hs[1]), (std::max)(hs[2], hs[3]));
+			}
+#endif
+			for (; i < n; i++) {
+				if (p[i] >= floor && p[i] <= FLT_MAX) {
+					lo = (std::min)(lo, p[i]);
+					hi = (std::max)(hi, p[i]);
+				}
+			}
+		}
+
+#if defined(W_VTK_SSE2)
+		/* log2 of positive normal floats to about 1e-3 (exponent + cubic of the mantissa). Only ever a first guess of the bin. */
+		inline __m128 fast_log2(__m128 v) {
+
+			const __m128i bits = _mm_castps_si128(v);
+			const __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+			const __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+			__m128 p = _mm_set1_ps(0.15270028f);
+			p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(-1.02680491f));
+			p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(3.01116215f));
+			p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(-2.13623207f));
+			return _mm_add_ps(exponent, p);
+		}
+#endif
+
+		/* Bins samples into partial counts. Counts are per slot: slot 0 is below, slot b + 1 is bin b, slot bins + 1 is
+		   above and slot bins + 2 NaN, so bins + 3 slots per partial. */
+		class Binner {
+
+		public:
+
+			Binner(size_t bins, Scale scale, double lo, double hi) : edges(bins + 1), bins(bins), scale(scale), lower(bins + 2) {
+
+				const bool log = (scale == LOG);
+				const double first = log ? std::log2(lo) : lo;
+				const double last = log ? std::log2(hi) : hi;
+				for (size_t b = 0; b <= bins; b++) {
+					const double t = first + (last - first) * static_cast<double>(b) / static_cast<double>(bins);
+					edges[b] = log ? std::exp2(t) : t;
+				}
+				edges[0] = lo;
+				edges[bins] = hi;
+
+				lower[0] = -std::numeric_limits<double>::infinity();
+				for (size_t s = 1; s <= bins; s++) {
+					lower[s] = edges[s - 1];
+				}
+				lower[bins + 1] = std::nextafter(hi, std::numeric_limits<double>::infinity());		// hi is in the last bin
+
+				base = static_cast<float>(first);
+				factor = static_cast<float>(static_cast<double>(bins) / (last - first));
+			}
+
+			size_t slots() const { return bins + 3; }
+
+			/* Adds n samples to 4 interleaved partials (slots() apart) */
+			void count(const float* p, size_t n, uint64_t* counts) const {
+				if (scale == LOG) {
+					count_run<true>(p, n, counts);
+				}
+				else {
+					count_run<false>(p, n, counts);
+				}
+			}
+
+			std::vector<double> edges;
+
+		private:
+
+			template<bool Log>
+			void count_run(const float* p, size_t n, uint64_t* counts) const {
+
+				const size_t stride = slots();
+				size_t i = 0;
+#if defined(W_VTK_SSE2)
+				const __m128 b = _mm_set1_ps(base), k = _mm_set1_ps(factor);
+				const __m128 first = _mm_set1_ps(-1.0f), last = _mm_set1_ps(static_cast<float>(bins));
+				const __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+				alignas(16) int32_t slot[4];
+				for (; i + 4 <= n; i += 4) {
+					const __m128 v = _mm_loadu_ps(p + i);
+					__m128 t = _mm_mul_ps(_mm_sub_ps(Log ? fast_log2(v) : v, b), k);
+					t = _mm_max_ps(_mm_min_ps(t, last), first);		// NaN -> last, settle() sorts it out
+					if (Log) {
+						const __m128 nonpositive = _mm_cmple_ps(v, zero);
+						t = _mm_or_ps(_mm_and_ps(nonpositive, first), _mm_andnot_ps(nonpositive, t));
+					}
+					_mm_store_si128(reinterpret_cast<__m128i*>(slot), _mm_cvttps_epi32(_mm_add_ps(t, one)));
+					counts[settle(p[i], static_cast<size_t>(slot[0]))]++;
+					counts[stride + settle(p[i + 1], static_cast<size_t>(slot[1]))]++;
+					counts[2 * stride + settle(p[i + 2], static_cast<size_t>(slot[2]))]++;
+					counts[3 * stride + settle(p[i + 3], static_cast<size_t>(slot[3]))]++;
+				}
+#endif
+				for (; i < n; i++) {
+					counts[settle(p[i], guess<Log>(p[i]))]++;
+				}
+			}
+
+			/* Scalar first guess of the slot (the tails and builds without SSE2) */
+			template<bool Log>
+			size_t guess(float v) const {
+
+				if (Log && !(v > 0.0f)) {
+					return 0;
+				}
+				const float t = ((Log ? std::log2(v) : v) - base) * factor;
+				if (!(t > -1.0f)) {
+					return 0;
+				}
+				if (t >= static_cast<float>(bins)) {
+					return bins + 1;
+				}
+				return static_cast<size_t>(t + 1.0f);
+			}
+
+			/* The exact slot of v from a guess that may be a bin or so off */
+			size_t settle(float v, size_t s) const {
+
+				if (v != v) {
+					return bins + 2;
+				}
+				while (s > 0 && v < lower[s]) {
+					s--;
+				}
+				while (s <= bins && v >= lower[s + 1]) {
+					s++;
+				}
+				return s;
+			}
+
+			size_t bins;
+			Scale scale;
+			std::vector<double> lower;		// Lowest value of each slot
+			float base, factor;				// Guess = (value or log2(value) - base) * factor
+		};
+
+		/* =================================================================================================================
+		Bin the samples in data (any series_view) with settings. False (see std::cerr) when the settings can't be used.
+		================================================================================================================= */
+		inline bool bin(const series_view& data, const Settings& settings, Bins& out) {
+
+			if (settings.bins == 0) {
+				std::cerr << "W_VTK::Histogram::bin: a histogram needs at least one bin\n";
+				return false;
+			}
+			if (settings.scale == LOG && !settings.auto_range() && !(settings.lo > 0.0)) {
+				std::cerr << "W_VTK::Histogram::bin: log bins need a range above 0, got lo = " << settings.lo << "\n";
+				return false;
+			}
+
+			// Worker w takes chunks [w * chunks / workers, (w + 1) * chunks / workers)
+			const size_t n = data.size;
+			const size_t chunks = (n + chunk_size - 1) / chunk_size;
+			const unsigned workers = worker_count(settings.threads, chunks);
+
+			double lo = settings.lo, hi = settings.hi;
+			if (settings.auto_range()) {
+
+				const float floor = (settings.scale == LOG) ? std::numeric_limits<float>::denorm_min() : -FLT_MAX;
+				std::vector<float> los(workers), his(workers);
+				parallel_for(workers, workers, [&](size_t w) {
+					std::vector<float> buffer;
+					los[w] = std::numeric_limits<float>::infinity();
+					his[w] = -los[w];
+					for (size_t c = w * chunks / workers; c < (w + 1) * chunks / workers; c++) {
+						const size_t first = c * chunk_size;
+						const size_t count = (std::min)(chunk_size, n - first);
+						float l, h;
+						finite_range(float_chunk(data, first, count, buffer), count, floor, l, h);
+						los[w] = (std::min)(los[w], l);
+						his[w] = (std::max)(his[w], h);
+					}
+				});
+				lo = *std::min_element(los.begin(), los.end());
+				hi = *std::max_element(his.begin(), his.end());
+
+				// No usable samples or all the same: a range around them so the edges stay apart
+				if (!(lo <= hi)) {
+					lo = (settings.scale == LOG) ? 1.0 : 0.0;
+					hi = (settings.scale == LOG) ? 10.0 : 1.0;
+				}
+				else if (lo == hi) {
+					if (settings.scale == LOG) {
+						lo /= 2.0;
+						hi *= 2.0;
+					}
+					else {
+						lo -= 0.5;
+						hi += 0.5;
+					}
+				}
+			}
+
+			const Binner binner(settings.bins, settings.scale, lo, hi);
+			const size_t slots = binner.slots();
+			std::vector<uint64_t> partials(static_cast<size_t>(workers) * 4 * slots, 0);
+			parallel_for(workers, workers, [&](size_t w) {
+				uint64_t* counts = partials.data() + w * 4 * slots;
+				std::vector<float> buffer;
+				for (size_t c = w * chunks / workers; c < (w + 1) * chunks / workers; c++) {
+					const size_t first = c * chunk_size;
+					const size_t count = (std::min)(chunk_size, n - first);
+					binner.count(float_chunk(data, first, count, buffer), count, counts);
+				}
+			});
+
+			// Merge the partials
+			out.scale = settings.scale;
+			out.edges = binner.edges;
+			out.counts.assign(settings.bins, 0);
+			out.below = out.above = out.invalid = 0;
+			for (size_t p = 0; p < static_cast<size_t>(workers) * 4; p++) {
+				const uint64_t* counts = partials.data() + p * slots;
+				out.below += counts[0];
+				for (size_t b = 0; b < settings.bins; b++) {
+					out.counts[b] += counts[b + 1];
+				}
+				out.above += counts[settings.bins + 1];
+				out.invalid += counts[settings.bins + 2];
+			}
+			return true;
+		}
+	}
+
+	namespace _2D {
+
+		/* ----- Notes -----:
+		Histogram_plotter draws Histogram::Bins as one vtkChart::BAR plot: a bar per bin at the bin's centre, as high as its
+		count, the bars touching (the chart's bar width fraction is set to 1). LOG bins are drawn over log10 of the samples
+		with the ticks at whole decades labelled in the samples' own units. Samples are only read while binning (nothing is
+		wrapped or kept) so there is no Ingestion mode. VTK puts the bar plots of one chart side by side, so give a histogram
+		its own chart (see multiplot_chart_instantiation) when using the chart variant. */
+
+		/* Adds the bars of bins to chart */
+		inline void histogram_bars(vtkChartXY* chart, const std::string& name, const Histogram::Bins& bins, const char* BarColour) {
+
+			const bool log = (bins.scale == Histogram::LOG);
+
+			// Bin centres and counts as the table (bins long)
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+			std::vector<float> centres(bins.size()), counts(bins.size());
+			for (size_t b = 0; b < bins.size(); b++) {
+				centres[b] = log ? static_cast<float>((std::log10(bins.edges[b]) + std::log10(bins.edges[b + 1])) / 2.0)
+								 : static_cast<float>((bins.edges[b] + bins.edges[b + 1]) / 2.0);
+				counts[b] = static_cast<float>(bins.counts[b]);
+			}
+			vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+			table->AddColumn(make_float_column(name.c_str(), series_view(centres), COPY));
+			table->AddColumn(make_float_column("Count", series_view(counts), COPY));
+			table_timer.stop();
+
+			// Named colours
+			const Colour_table* colors = named_colours();
+
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+			vtkPlot* bars = chart->AddPlot(vtkChart::BAR);
+			bars->SetInputData(table, 0, 1);
+			bars->GetBrush()->SetColorF(colors->GetColor3d(BarColour).GetData());
+			bars->GetPen()->SetColorF(colors->GetColor3d(BarColour).GetData());
+			chart->SetBarWidthFraction(1.0f);
+			chart->GetAxis(vtkAxis::BOTTOM)->SetTitle(name);
+			chart->GetAxis(vtkAxis::LEFT)->SetTitle("Count");
+
+			// Log bins: ticks at the decades (or the two ends when the range is inside one), labelled with the samples' values
+			if (log && !bins.edges.empty()) {
+				const double lo = std::log10(bins.edges.front()), hi = std::log10(bins.edges.back());
+				std::vector<double> ticks;
+				for (double decade = std::ceil(lo); decade <= hi; decade++) {
+					ticks.push_back(decade);
+				}
+				if (ticks.size() < 2) {
+					ticks.assign(1, lo);
+					ticks.push_back(hi);
+				}
+
+				vtkSmartPointer<vtkDoubleArray> positions = vtkSmartPointer<vtkDoubleArray>::New();
+				vtkSmartPointer<vtkStringArray> labels = vtkSmartPointer<vtkStringArray>::New();
+				for (double tick : ticks) {
+					std::ostringstream label;
+					label << std::pow(10.0, tick);
+					positions->InsertNextValue(tick);
+					labels->InsertNextValue(label.str().c_str());
+				}
+				chart->GetAxis(vtkAxis::BOTTOM)->SetCustomTickPositions(positions, labels);
+			}
+		}
+
+		/* =================================================================================================================
+		Plot an already binned histogram (e.g. bins kept from Histogram::bin to redraw).
+		False when the bins and edges don't match or the headless image isn't written.
+		=================================================================================================================== */
+		inline bool Histogram_plotter(const std::string& name, const Histogram::Bins& bins, const char* BarColour = "SteelBlue", const RenderTarget& target = RenderTarget()) {
+
+			Instrumentation::Scope instrumentation("_2D::Histogram_plotter");
+			if (bins.edges.size() != bins.size() + 1) {
+				std::cerr << "W_VTK::_2D::Histogram_plotter: " << bins.size() << " bins need " << bins.size() + 1 << " edges, got " << bins.edges.size() << "\n";
+				return false;
+			}
+
+			vtkSmartPointer<vtkChartXY> chart = vtkSmartPointer<vtkChartXY>::New();
+			histogram_bars(chart, name, bins, BarColour);
+			Instrumentation::update_measured(chart.GetPointer());
+
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(chart, default_background, target);
+			}
+
+			// Set up the view
+			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
+			view->GetRenderer()->SetBackground(1.0, 1.0, 1.0);
+			view->GetScene()->AddItem(chart);
+
+			// Start interactor and render window
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
+			view->GetRenderWindow()->Render();
+			render_timer.stop();
+			instrumentation.finish();
+			view->GetInteractor()->Initialize();
+			view->GetInteractor()->Start();
+			return true;
+		}
+
+		/* =================================================================================================================
+		Bin the samples (binning is the CONVERSION stage) and plot them as a histogram.
+		False when the settings are rejected (see std::cerr) or the headless image isn't written.
+		=================================================================================================================== */
+		inline bool Histogram_plotter(const std::string& name, series_view data, const Histogram::Settings& settings = Histogram::Settings(), const char* BarColour = "SteelBlue", const RenderTarget& target = RenderTarget()) {
+
+			Instrumentation::Scope instrumentation("_2D::Histogram_plotter");
+
+			Instrumentation::Stage_timer conversion(Instrumentation::CONVERSION);
+			Histogram::Bins bins;
+			if (!Histogram::bin(data, settings, bins)) { return false; }
+			conversion.stop();
+
+			return Histogram_plotter(name, bins, BarColour, target);
+		}
+
+		/* =================================================================================================================
+		Histogram creator which adds the bars to the inputted chart (see multiplot_chart_instantiation)
+		================================================================================================================= */
+		inline void Histogram_plotter(vtkSmartPointer<vtkChartXY>& chart, const std::string& name, series_view data, const Histogram::Settings& settings = Histogram::Settings(), const char* BarColour = "SteelBlue") {
+
+			Instrumentation::Scope instrumentation("_2D::Histogram_plotter");
+
+			Instrumentation::Stage_timer conversion(Instrumentation::CONVERSION);
+			Histogram::Bins bins;
+			if (!Histogram::bin(data, settings, bins)) { return; }
+			conversion.stop();
+
+			histogram_bars(chart, name, bins, BarColour);
+		}
+
+		/* data[numPoints] as it is (read in place) */
+		template<int numPoints, typename T>
+		void Histogram_plotter(const std::string& name, T(&data)[numPoints], const Histogram::Settings& settings = Histogram::Settings(), const char* BarColour = "SteelBlue", const RenderTarget& target = RenderTarget()) {
+			Histogram_plotter(name, series_view(data, numPoints), settings, BarColour, target);
+		}
+	}
+}
@@ -0,0 +1,251 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------------ Instrumentation: per stage timings and collumn bytes for each plot ---------------
+ ==================================================================================================*/
+
+/* External modules */
+#include <chrono>
+#include <atomic>
+#include <cstddef>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	namespace Instrumentation {
+
+		/* ----- Notes -----:
+		Every plotter reports (per call) how long each stage took and how many bytes its collumns allocated:
+			CONVERSION	-> level of detail / reshaping the callers data before VTK sees it
+			TABLE		-> building the vtkTable collumns (copies and strided gathers are counted in column_bytes, borrowed collumns and
+						   copies into collumns reused from the Column_pool are 0, the latter are counted in pooled_columns)
+			LAYOUT		-> adding and styling the plots and updating the chart (VTK builds its plot caches here)
+			RENDER		-> the first frame (and the image write for offscreen targets). The interactive loop is not counted:
+						   interactive plotters report after the first frame (Scope::finish), before the window blocks.
+		Stats are delivered to a process wide callback (set_callback) and/or a Stats struct for plots made on the current thread
+		while a Capture is alive:
+			Instrumentation::Stats stats;
+			{ Instrumentation::Capture capture(stats); _2D::Line_plotter(...); }
+		With neither set the hooks are one relaxed load per plot and no clock reads. Define W_VTK_NO_INSTRUMENTATION to compile them out. */
+
+		enum Stage {
+			CONVERSION, TABLE, LAYOUT, RENDER, NUM_STAGES
+		};
+
+		struct Stats {
+
+			const char* plotter;			// Which plotter (e.g. "_2D::Line_plotter")
+			double seconds[NUM_STAGES];
+			size_t columns;					// Collumns made
+			size_t column_bytes;			// Bytes allocated for them
+			size_t pooled_columns;			// Of those, reused from the Column_pool (nothing allocated)
+
+			Stats() { clear(); }
+
+			void clear() {
+				plotter = "";
+				for (int s = 0; s < NUM_STAGES; s++) {
+					seconds[s] = 0.0;
+				}
+				columns = 0;
+				column_bytes = 0;
+				pooled_columns = 0;
+			}
+
+			double total_seconds() const {
+				double total = 0.0;
+				for (int s = 0; s < NUM_STAGES; s++) {
+					total += seconds[s];
+				}
+				return total;
+			}
+		};
+
+		typedef void (*Callback)(const Stats& stats, void* user);
+
+#if !defined(W_VTK_NO_INSTRUMENTATION)
+
+		/* Process wide callback */
+		struct Callback_slot {
+			std::atomic<Callback> callback;
+			std::atomic<void*> user;
+		};
+
+		inline Callback_slot& callback_slot() {
+			static Callback_slot slot = { { nullptr }, { nullptr } };
+			return slot;
+		}
+
+		/* What the current thread is collecting */
+		struct Thread_state {
+			int depth;			// Nested plotter calls (e.g. the LOD path calling another plotter) report once
+			bool collecting;
+			bool delivered;
+			Stats stats;
+			Stats* sink;		// Capture
+		};
+
+		inline Thread_state& thread_state() {
+			thread_local Thread_state state = { 0, false, false, Stats(), nullptr };
+			return state;
+		}
+
+		/* Report every plot to callback(stats, user). nullptr switches it off. */
+		inline void set_callback(Callback callback, void* user = nullptr) {
+			callback_slot().user.store(user, std::memory_order_relaxed);
+			callback_slot().callback.store(callback, std::memory_order_release);
+		}
+
+		/* Is the current plot being measured? */
+		inline bool active() {
+			return thread_state().collecting;
+		}
+
+		/* Collect the stats of the plots made on this thread while alive (the last plot wins) */
+		class Capture {
+
+		public:
+
+			explicit Capture(Stats& out) : previous(thread_state().sink) { thread_state().sink = &out; }
+			~Capture() { thread_state().sink = previous; }
+
+		private:
+
+			Capture(const Capture&) = delete;
+			Capture& operator=(const Capture&) = delete;
+
+			Stats* previous;
+		};
+
+		/* One per plotter call: starts collecting if anyone is listening and reports when done */
+		class Scope {
+
+		public:
+
+			explicit Scope(const char* plotter) {
+
+				Thread_state& state = thread_state();
+				if (state.depth++ == 0) {
+					state.delivered = false;
+					state.collecting = (state.sink != nullptr) || (callback_slot().callback.load(std::memory_order_acquire) != nullptr);
+					if (state.collecting) {
+						state.stats.clear();
+						state.stats.plotter = plotter;
+					}
+				}
+			}
+
+			~Scope() {
+				if (thread_state().depth == 1) {
+					finish();
+					thread_state().collecting = false;
+				}
+				thread_state().depth--;
+			}
+
+			/* Report now (e.g. before an interactive window blocks). Later calls for the same plot do nothing. */
+			void finish() {
+
+				Thread_state& state = thread_state();
+				if (!state.collecting || state.delivered) {
+					return;
+				}
+				state.delivered = true;
+
+				if (state.sink) {
+					*state.sink = state.stats;
+				}
+				Callback callback = callback_slot().callback.load(std::memory_order_acquire);
+				if (callback) {
+					callback(state.stats, callback_slot().user.load(std::memory_order_relaxed));
+				}
+			}
+
+		private:
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		};
+
+		/* Adds the time until it goes out of scope to a stage (stages may be timed in several pieces) */
+		class Stage_timer {
+
+		public:
+
+			explicit Stage_timer(Stage stage) : stage(stage), timing(active()) {
+				if (timing) {
+					start = std::chrono::steady_clock::now();
+				}
+			}
+
+			~Stage_timer() { stop(); }
+
+			/* Stop early (the rest of the scope isn't part of the stage) */
+			void stop() {
+				if (timing) {
+					thread_state().stats.seconds[stage] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+					timing = false;
+				}
+			}
+
+		private:
+
+			Stage_timer(const Stage_timer&) = delete;
+			Stage_timer& operator=(const Stage_timer&) = delete;
+
+			Stage stage;
+			bool timing;
+			std::chrono::steady_clock::time_point start;
+		};
+
+		/* Called by make_column */
+		inline void count_column(size_t bytes, bool pooled = false) {
+			Thread_state& state = thread_state();
+			if (state.collecting) {
+				state.stats.columns++;
+				state.stats.column_bytes += bytes;
+				state.stats.pooled_columns += pooled ? 1 : 0;
+			}
+		}
+
+		/* Measured plots update the chart up front so VTK's plot cache building counts as LAYOUT rather than RENDER */
+		template<typename Item>
+		void update_measured(Item* item) {
+			if (active()) {
+				Stage_timer layout(LAYOUT);
+				item->Update();
+			}
+		}
+
+#else
+
+		/* Compiled out: same interface, no state and no code */
+		inline void set_callback(Callback, void* = nullptr) {}
+		inline bool active() { return false; }
+
+		class Capture {
+		public:
+			explicit Capture(Stats&) {}
+		};
+
+		class Scope {
+		public:
+			explicit Scope(const char*) {}
+			void finish() {}
+		};
+
+		class Stage_timer {
+		public:
+			explicit Stage_timer(Stage) {}
+			void stop() {}
+		};
+
+		inline void count_column(size_t, bool = false) {}
+
+		template<typename Item>
+		void update_measured(Item*) {}
+
+#endif
+	}
+}
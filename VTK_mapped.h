@@ -0,0 +1,350 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------ Memory mapped input: raw binary collumn files and .npy arrays --------------------------
+ ==================================================================================================*/
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_parallel.h"
+
+/* External modules */
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	/* ----- Notes -----:
+	Files bigger than RAM are mapped rather than read: map_raw / map_npy only map the file (O(1), no read, no heap buffer)
+	and hand out series_views straight into the mapped pages, so they BORROW into the plotters with no copy:
+		Mapped_array time = map_raw("time.f32", FLOAT32);		// one float32 collumn
+		Mapped_array trace = map_npy("trace.npy");				// shape (lines, points), C order
+		_2D::Line_plotter(names, time.column(0), { trace.row(0), trace.row(1) });
+	Pages are read by the OS when something touches them and, being clean file pages, can be dropped again under memory
+	pressure, so resident memory follows what is actually drawn (e.g. the visible window of a LOD::ZoomIndex).
+	The mapping is read only: use BORROW or COPY, never TAKE_OWNERSHIP (nothing to delete[]). The Mapped_array must outlive
+	the plot, as for any borrowed data.
+	Views keep the file's value type (float32, float64, int32, int16, uint8, see series_view) so they are wrapped as they
+	are; row_as_float / column_as_float make a float copy for code that wants one. Little endian files only (as written
+	by numpy on x86/ARM). */
+
+	/* How the plot will walk the file (madvise hint, ignored on Windows).
+	   SEQUENTIAL -> read ahead, e.g. plotting every point. RANDOM -> no read ahead, e.g. zoomed windows of a huge trace. */
+	enum Access {
+		NORMAL, SEQUENTIAL, RANDOM
+	};
+
+	/* =================================================================================================================
+	Read only mapping of a whole file. Movable, not copyable; unmapped on destruction.
+	================================================================================================================= */
+	class Mapped_file {
+
+	public:
+
+		Mapped_file() : base(nullptr), length(0) {}
+
+		explicit Mapped_file(const std::string& path, Access access = NORMAL) : base(nullptr), length(0) {
+
+#if defined(_WIN32)
+			HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) {
+				std::cerr << "W_VTK::Mapped_file: can't open " << path << "\n";
+				return;
+			}
+			LARGE_INTEGER bytes;
+			if (GetFileSizeEx(file, &bytes) && bytes.QuadPart > 0) {
+				HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (mapping != nullptr) {
+					base = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+					CloseHandle(mapping);	// The view keeps the mapping alive
+				}
+				length = base ? static_cast<size_t>(bytes.QuadPart) : 0;
+			}
+			CloseHandle(file);
+			(void)access;
+#else
+			const int file = ::open(path.c_str(), O_RDONLY);
+			if (file < 0) {
+				std::cerr << "W_VTK::Mapped_file: can't open " << path << "\n";
+				return;
+			}
+			struct stat info;
+			if (fstat(file, &info) == 0 && info.st_size > 0) {
+				void* pages = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+				if (pages != MAP_FAILED) {
+					base = static_cast<const unsigned char*>(pages);
+					length = static_cast<size_t>(info.st_size);
+					const int advice[3] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM };
+					madvise(pages, length, advice[access]);
+				}
+			}
+			::close(file);	// The mapping keeps the file alive
+#endif
+			if (base == nullptr) {
+				std::cerr << "W_VTK::Mapped_file: can't map " << path << " (empty or unreadable)\n";
+			}
+		}
+
+		~Mapped_file() { unmap(); }
+
+		Mapped_file(Mapped_file&& other) : base(other.base), length(other.length) {
+			other.base = nullptr;
+			other.length = 0;
+		}
+
+		Mapped_file& operator=(Mapped_file&& other) {
+			if (this != &other) {
+				unmap();
+				base = other.base;
+				length = other.length;
+				other.base = nullptr;
+				other.length = 0;
+			}
+			return *this;
+		}
+
+		Mapped_file(const Mapped_file&) = delete;
+		Mapped_file& operator=(const Mapped_file&) = delete;
+
+		bool valid() const { return base != nullptr; }
+		const unsigned char* data() const { return base; }
+		size_t size() const { return length; }
+
+	private:
+
+		void unmap() {
+			if (base != nullptr) {
+#if defined(_WIN32)
+				UnmapViewOfFile(base);
+#else
+				munmap(const_cast<unsigned char*>(base), length);
+#endif
+			}
+			base = nullptr;
+			length = 0;
+		}
+
+		const unsigned char* base;
+		size_t length;
+	};
+
+	/* =================================================================================================================
+	A mapped 2D array: rows x cols values of one type, row major (C order) or collumn major (Fortran order).
+	1D files are rows x 1. Rows of a C order array and collumns of a Fortran order one are contiguous, the other
+	direction is a strided view (gathered into a new collumn by the plotters, see make_column).
+	================================================================================================================= */
+	class Mapped_array {
+
+	public:
+
+		Mapped_array() : values(nullptr), value_type(FLOAT32), num_rows(0), num_cols(0), column_major(false) {}
+
+		Mapped_array(Mapped_file&& file, size_t offset, Value_type type, size_t rows, size_t cols, bool column_major)
+			: file(std::move(file)), values(this->file.data() + offset), value_type(type), num_rows(rows), num_cols(cols), column_major(column_major) {}
+
+		bool valid() const { return file.valid(); }
+		Value_type type() const { return value_type; }
+		size_t rows() const { return num_rows; }
+		size_t cols() const { return num_cols; }
+		bool fortran_order() const { return column_major; }
+
+		/* Raw values (type() decides how to read them) */
+		const void* data() const { return values; }
+
+		/* Row r / collumn c as a view into the mapped pages (of the file's value type) */
+		series_view row(size_t r) const {
+			if (!range_check("row", r, num_rows)) { return series_view(); }
+			return view(column_major ? r : r * num_cols, num_cols, column_major ? num_rows : 1);
+		}
+
+		series_view column(size_t c) const {
+			if (!range_check("column", c, num_cols)) { return series_view(); }
+			return view(column_major ? c * num_rows : c, num_rows, column_major ? 1 : num_cols);
+		}
+
+		/* Row r / collumn c converted to float (in parallel chunks). The vector owns the copy. */
+		std::vector<float> row_as_float(size_t r, unsigned threads = 0) const {
+			return convert(row(r), threads);
+		}
+
+		std::vector<float> column_as_float(size_t c, unsigned threads = 0) const {
+			return convert(column(c), threads);
+		}
+
+	private:
+
+		bool range_check(const char* what, size_t index, size_t count) const {
+			if (!valid() || index >= count) {
+				std::cerr << "W_VTK::Mapped_array::" << what << ": " << index << " out of range (" << count << ")\n";
+				return false;
+			}
+			return true;
+		}
+
+		/* count values from value "first" on, every stride'th */
+		series_view view(size_t first, size_t count, size_t stride) const {
+			const ptrdiff_t step = static_cast<ptrdiff_t>(stride);
+			switch (value_type) {
+			case FLOAT64:	return series_view(reinterpret_cast<const double*>(values) + first, count, step);
+			case INT32:		return series_view(reinterpret_cast<const int32_t*>(values) + first, count, step);
+			case INT16:		return series_view(reinterpret_cast<const int16_t*>(values) + first, count, step);
+			case UINT8:		return series_view(reinterpret_cast<const uint8_t*>(values) + first, count, step);
+			default:		return series_view(reinterpret_cast<const float*>(values) + first, count, step);
+			}
+		}
+
+		static std::vector<float> convert(const series_view& view, unsigned threads) {
+
+			std::vector<float> out(view.size);
+			const size_t chunk = 1 << 20;
+			parallel_for((view.size + chunk - 1) / chunk, threads, [&](size_t c) {
+				const size_t end = (c + 1) * chunk < view.size ? (c + 1) * chunk : view.size;
+				for (size_t i = c * chunk; i < end; i++) {
+					out[i] = view[i];
+				}
+			});
+			return out;
+		}
+
+		Mapped_file file;
+		const unsigned char* values;
+		Value_type value_type;
+		size_t num_rows, num_cols;
+		bool column_major;
+	};
+
+	/* =================================================================================================================
+	Map a headerless file of "columns" collumns (1 -> a plain collumn file). offset skips a header of that many bytes.
+	column_major -> every collumn in one piece, one after the other. Otherwise rows (records) one after the other.
+	================================================================================================================= */
+	inline Mapped_array map_raw(const std::string& path, Value_type type, size_t columns = 1, bool column_major = false, size_t offset = 0, Access access = NORMAL) {
+
+		Mapped_file file(path, access);
+		if (!file.valid()) { return Mapped_array(); }
+
+		const size_t element = value_size(type);
+		if (columns == 0 || offset % element != 0 || offset > file.size()) {
+			std::cerr << "W_VTK::map_raw: " << path << ": need columns > 0 and an offset within the file that is a multiple of " << element << " bytes\n";
+			return Mapped_array();
+		}
+
+		const size_t record = columns * element;
+		const size_t rows = (file.size() - offset) / record;
+		if ((file.size() - offset) % record != 0) {
+			std::cerr << "W_VTK::map_raw: " << path << ": " << (file.size() - offset) % record << " trailing bytes ignored\n";
+		}
+		return Mapped_array(std::move(file), offset, type, rows, columns, column_major);
+	}
+
+	/* =================================================================================================================
+	Map a .npy file (format versions 1-3) of little endian float32, float64, int32, int16 or uint8 values, 1D or 2D.
+	A 2D array of shape (lines, points) in C order has each line as a contiguous row, like data[numLines][numPoints].
+	================================================================================================================= */
+	inline Mapped_array map_npy(const std::string& path, Access access = NORMAL) {
+
+		Mapped_file file(path, access);
+		if (!file.valid()) { return Mapped_array(); }
+
+		auto fail = [&path](const char* why) {
+			std::cerr << "W_VTK::map_npy: " << path << ": " << why << "\n";
+			return Mapped_array();
+		};
+
+		// ----- Preamble: magic, version, header length -----
+		const unsigned char* p = file.data();
+		if (file.size() < 10 || std::memcmp(p, "\x93NUMPY", 6) != 0) { return fail("not a .npy file"); }
+		const int major = p[6];
+		size_t header_length, start;
+		if (major == 1) {
+			header_length = p[8] | (p[9] << 8);
+			start = 10;
+		}
+		else if (major == 2 || major == 3) {
+			if (file.size() < 12) { return fail("truncated header"); }
+			header_length = static_cast<size_t>(p[8]) | (static_cast<size_t>(p[9]) << 8) | (static_cast<size_t>(p[10]) << 16) | (static_cast<size_t>(p[11]) << 24);
+			start = 12;
+		}
+		else {
+			return fail("unsupported format version");
+		}
+		if (start + header_length > file.size()) { return fail("truncated header"); }
+
+		// ----- Header: a python dict literal, e.g. {'descr': '<f4', 'fortran_order': False, 'shape': (1000, 4096), } -----
+		const std::string header(reinterpret_cast<const char*>(p + start), header_length);
+		auto value_of = [&header](const char* key) -> size_t {
+			const size_t at = header.find(key);
+			return (at == std::string::npos) ? at : header.find(':', at) + 1;
+		};
+
+		const size_t descr = value_of("'descr'");
+		const size_t order = value_of("'fortran_order'");
+		const size_t shape = value_of("'shape'");
+		if (descr == std::string::npos || order == std::string::npos || shape == std::string::npos) { return fail("malformed header"); }
+
+		const size_t quote = header.find_first_of("'\"", descr);
+		const std::string type_name = (quote == std::string::npos) ? std::string() : header.substr(quote + 1, 3);
+		const char* type_names[] = { "<f4", "<f8", "<i4", "<i2", "|u1" };
+		const Value_type types[] = { FLOAT32, FLOAT64, INT32, INT16, UINT8 };
+		int found = -1;
+		for (int t = 0; t < 5; t++) {
+			found = (type_name == type_names[t]) ? t : found;
+		}
+		if (found < 0) {
+			return fail("only little endian float32, float64, int32, int16 and uint8 ('<f4' '<f8' '<i4' '<i2' '|u1') are supported");
+		}
+		const Value_type type = types[found];
+
+		const size_t flag = header.find_first_not_of(' ', order);
+		const bool column_major = (flag != std::string::npos) && header.compare(flag, 4, "True") == 0;
+
+		// Shape tuple: (n,) or (rows, cols)
+		const size_t open = header.find('(', shape);
+		const size_t close = header.find(')', open);
+		if (open == std::string::npos || close == std::string::npos) { return fail("malformed shape"); }
+		std::vector<size_t> dims;
+		const char* cursor = header.c_str() + open + 1;
+		const char* end = header.c_str() + close;
+		while (cursor < end) {
+			char* next = nullptr;
+			const unsigned long long dim = std::strtoull(cursor, &next, 10);
+			if (next == cursor) {
+				cursor++;	// ',' or ' '
+				continue;
+			}
+			dims.push_back(static_cast<size_t>(dim));
+			cursor = next;
+		}
+		if (dims.empty() || dims.size() > 2) { return fail("only 1D and 2D arrays are supported"); }
+
+		const size_t rows = dims[0];
+		const size_t cols = (dims.size() == 2) ? dims[1] : 1;
+		const size_t offset = start + header_length;
+		if (offset + rows * cols * value_size(type) > file.size()) { return fail("file is shorter than its shape"); }
+		if (offset % value_size(type) != 0) { return fail("data is not aligned to its element size"); }
+
+		return Mapped_array(std::move(file), offset, type, rows, cols, column_major);
+	}
+}
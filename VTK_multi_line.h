@@ -0,0 +1,485 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------ Multi-line plot: thousands of 2D series (e.g. ensemble members) as one chart item ------
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkChartXY.h>
+#include <vtkPlot.h>
+#include <vtkPen.h>
+#include <vtkContext2D.h>
+#include <vtkContextView.h>
+#include <vtkContextScene.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkStringArray.h>
+#include <vtkRect.h>
+#include <vtkVector.h>
+#include <vtkStdString.h>
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_decimation.h"
+#include "VTK_output.h"
+#include "VTK_colours.h"
+#include "VTK_instrumentation.h"
+#include "VTK_parallel.h"
+#include "VTK_2D_plotter.h"
+
+/* External modules */
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	namespace _2D {
+
+		/* ----- Notes -----:
+		Line_plotter adds one vtkPlotLine per line, so 5000 ensemble members are 5000 plots the chart paints, lays out in the
+		legend and hit-tests one by one. Multi_line_plot is ONE vtkPlot holding every series:
+			data		-> all series in one place: contiguous BORROW views are kept as they are, COPY and strided data is
+						   gathered series after series into one owned block. SetData and the chart variant COPY by default
+						   (the plot outlives the call), the standalone plotters BORROW.
+			paint		-> the segments of every series are cached once (shifted/scaled like vtkPlotPoints) with a colour per
+						   vertex and drawn with a single DrawLines call. The cache is only rebuilt when the data, colours or
+						   the chart's shift/scale change, so a frame costs one pass over the points and nothing per series
+			legend		-> at most max_legend entries: the first series by name and "+N more" for the rest
+			tooltip		-> series with sorted x (the usual case) are hit-tested with a binary search each, so a mouse move is
+						   O(series * log(points)). Series with unsorted x are drawn but not hit-tested.
+		Selection is off (the chart would need an id array per series). */
+
+		class Multi_line_plot : public vtkPlot {
+
+		public:
+
+			static Multi_line_plot* New() {
+				Multi_line_plot* plot = new Multi_line_plot;
+				plot->InitializeObjectBase();
+				return plot;
+			}
+
+			/* Hand over the series. x_pos -> one view shared by every series or one per series, x_pos[j] and data[j] the same
+			   size. TAKE_OWNERSHIP memory is freed with the plot (or straight away if it had to be gathered), strided views stay
+			   the caller's (see make_float_column). */
+			bool SetData(const std::vector<std::string>& names, const std::vector<series_view>& x_pos, const std::vector<series_view>& data, Ingestion mode = COPY, unsigned threads = 0) {
+
+				const size_t count = data.size();
+				if (!series_size_check("Multi_line_plot", count, names.size(), "names")) { return false; }
+				if (x_pos.size() != 1 && !series_size_check("Multi_line_plot", count, x_pos.size(), "x_pos")) { return false; }
+				for (size_t j = 0; j < count; j++) {
+					if (!series_size_check("Multi_line_plot", x_pos[x_pos.size() == 1 ? 0 : j].size, data[j].size, names[j].c_str())) { return false; }
+				}
+
+				Release();
+				Threads = threads;
+				Names = names;
+
+				// Gather COPY and strided views into one block, allocated once so the views into it stay valid
+				auto gathered = [mode](const series_view& view) { return mode == COPY || !view.contiguous(); };
+				size_t total = 0;
+				for (const series_view& view : x_pos) {
+					total += gathered(view) ? view.size : 0;
+				}
+				for (const series_view& view : data) {
+					total += gathered(view) ? view.size : 0;
+				}
+				Block.resize(total);
+
+				size_t cursor = 0;
+				std::vector<std::pair<series_view, Ingestion>> released;
+				auto keep = [&](const series_view& view, Ingestion row_mode) {
+					if (!gathered(view)) {
+						if (row_mode == TAKE_OWNERSHIP || row_mode == TAKE_OWNERSHIP_OF_BLOCK) {
+							Owned.push_back(view.data);
+						}
+						return view;
+					}
+					float* out = Block.data() + cursor;
+					for (size_t i = 0; i < view.size; i++) {
+						out[i] = view[i];
+					}
+					cursor += view.size;
+					if (view.stride == 1) {
+						released.push_back(std::make_pair(view, row_mode));
+					}
+					return series_view(out, view.size);
+				};
+
+				// A shared x is its own allocation so takes the plain mode, the rows of a block share one owner (see block_row_mode)
+				Xs.resize(x_pos.size());
+				for (size_t j = 0; j < x_pos.size(); j++) {
+					Xs[j] = keep(x_pos[j], (x_pos.size() == 1) ? mode : block_row_mode(mode, static_cast<int>(j)));
+				}
+				Ys.resize(count);
+				for (size_t j = 0; j < count; j++) {
+					Ys[j] = keep(data[j], block_row_mode(mode, static_cast<int>(j)));
+				}
+				for (const std::pair<series_view, Ingestion>& view : released) {
+					release_unwrapped(view.first, view.second);
+				}
+
+				ScanData();
+				if (Colours.size() != 4 * count) {
+					SetColours(nullptr);
+				}
+				LabelsDirty = true;
+				VerticesDirty = true;
+				this->Modified();
+				return true;
+			}
+
+			/* Every series in one named colour, or nullptr -> the next palette colour per series (seed with Palette::set_default_seed).
+			   opacity < 1 lets dense ensembles show where the members bunch up. */
+			void SetColours(const char* ColourName, double opacity = 1.0) {
+
+				const vtkColor3d named = named_colours()->GetColor3d(ColourName ? ColourName : "Black");
+				const unsigned char alpha = static_cast<unsigned char>((std::min)((std::max)(opacity, 0.0), 1.0) * 255.0 + 0.5);
+				Palette palette;
+
+				Colours.resize(4 * Ys.size());
+				for (size_t j = 0; j < Ys.size(); j++) {
+					const vtkColor3d colour = ColourName ? named : palette.next();
+					for (int c = 0; c < 3; c++) {
+						Colours[4 * j + c] = static_cast<unsigned char>(colour.GetData()[c] * 255.0 + 0.5);
+					}
+					Colours[4 * j + 3] = alpha;
+				}
+				VerticesDirty = true;
+				this->Modified();
+			}
+
+			/* Legend entries before the rest are folded into "+N more" */
+			void SetMaxLegend(size_t entries) {
+				MaxLegend = (entries < 1) ? 1 : entries;
+				LabelsDirty = true;
+				this->Modified();
+			}
+
+			size_t GetNumberOfSeries() const { return Ys.size(); }
+
+			/* ----- vtkPlot -----: */
+
+			void Update() override {
+				UpdateVertices();
+			}
+
+			bool Paint(vtkContext2D* painter) override {
+
+				UpdateVertices();
+				if (Vertices.empty()) {
+					return true;
+				}
+
+				// One draw for every series. DrawLines takes an int vertex count so huge caches go in (even sized) chunks.
+				painter->ApplyPen(this->Pen);
+				const size_t vertices = Vertices.size() / 2;
+				const size_t chunk = size_t(1) << 30;
+				for (size_t first = 0; first < vertices; first += chunk) {
+					const size_t n = (std::min)(chunk, vertices - first);
+					painter->DrawLines(Vertices.data() + 2 * first, static_cast<int>(n), VertexColours.data() + 4 * first, 4);
+				}
+				return true;
+			}
+
+			bool PaintLegend(vtkContext2D* painter, const vtkRectf& rect, int legendIndex) override {
+
+				// Named entries take their series' colour, the "+N more" entry is grey
+				const unsigned char grey[4] = { 128, 128, 128, 255 };
+				const size_t entry = static_cast<size_t>(legendIndex);
+				const unsigned char* colour = (entry < NamedEntries()) ? &Colours[4 * entry] : grey;
+
+				painter->ApplyPen(this->Pen);
+				painter->GetPen()->SetColor(colour[0], colour[1], colour[2], colour[3]);
+				const float y = rect.GetY() + 0.5f * rect.GetHeight();
+				painter->DrawLine(rect.GetX(), y, rect.GetX() + rect.GetWidth(), y);
+				return true;
+			}
+
+			vtkStringArray* GetLabels() override {
+
+				if (LabelsDirty) {
+					const size_t named = NamedEntries();
+					const size_t entries = named + ((named < Ys.size()) ? 1 : 0);
+					Legend->SetNumberOfValues(static_cast<vtkIdType>(entries));
+					for (size_t j = 0; j < named; j++) {
+						Legend->SetValue(static_cast<vtkIdType>(j), Names[j].c_str());
+					}
+					if (named < Ys.size()) {
+						Legend->SetValue(static_cast<vtkIdType>(named), ("+" + std::to_string(Ys.size() - named) + " more").c_str());
+					}
+					LabelsDirty = false;
+				}
+				return Legend;
+			}
+
+			/* Bounds of the data as the chart draws it (shifted/scaled) and as it was given */
+			void GetBounds(double bounds[4]) override {
+
+				const vtkRectd shift_scale = this->ShiftScale;
+				bounds[0] = (Bounds[0] + shift_scale.GetX()) * shift_scale.GetWidth();
+				bounds[1] = (Bounds[1] + shift_scale.GetX()) * shift_scale.GetWidth();
+				bounds[2] = (Bounds[2] + shift_scale.GetY()) * shift_scale.GetHeight();
+				bounds[3] = (Bounds[3] + shift_scale.GetY()) * shift_scale.GetHeight();
+			}
+
+			void GetUnscaledInputBounds(double bounds[4]) override {
+				std::memcpy(bounds, Bounds, sizeof(Bounds));
+			}
+
+			/* Point nearest "point" (plot coordinates) within tolerance: returns its index in the series and the series in segmentId */
+			vtkIdType GetNearestPoint(const vtkVector2f& point, const vtkVector2f& tolerance, vtkVector2f* location, vtkIdType* segmentId) override {
+
+				const vtkRectd shift_scale = this->ShiftScale;
+				if (shift_scale.GetWidth() == 0.0 || shift_scale.GetHeight() == 0.0) {
+					return -1;
+				}
+
+				// Back to data coordinates
+				const double px = point.GetX() / shift_scale.GetWidth() - shift_scale.GetX();
+				const double py = point.GetY() / shift_scale.GetHeight() - shift_scale.GetY();
+				const double tx = std::fabs(tolerance.GetX() / shift_scale.GetWidth());
+				const double ty = std::fabs(tolerance.GetY() / shift_scale.GetHeight());
+
+				vtkIdType nearest = -1;
+				double best = ty;
+				for (size_t j = 0; j < Ys.size(); j++) {
+
+					const series_view& x = X(j);
+					if (x.size == 0 || !Sorted[(Xs.size() == 1) ? 0 : j]) {
+						continue;
+					}
+
+					// Closest x either side of px
+					const size_t above = static_cast<size_t>(std::lower_bound(x.data, x.data + x.size, static_cast<float>(px)) - x.data);
+					for (size_t i = (above > 0) ? above - 1 : 0; i <= above && i < x.size; i++) {
+						const double dy = std::fabs(Ys[j][i] - py);
+						if (std::fabs(x[i] - px) <= tx && dy <= best) {
+							best = dy;
+							nearest = static_cast<vtkIdType>(i);
+							*segmentId = static_cast<vtkIdType>(j);
+							*location = vtkVector2f(static_cast<float>((x[i] + shift_scale.GetX()) * shift_scale.GetWidth()),
+													static_cast<float>((Ys[j][i] + shift_scale.GetY()) * shift_scale.GetHeight()));
+						}
+					}
+				}
+				return nearest;
+			}
+
+			/* Series name and the point (data coordinates) under the mouse */
+			vtkStdString GetTooltipLabel(const vtkVector2d& plotPos, vtkIdType, vtkIdType segmentIndex) override {
+
+				std::ostringstream label;
+				if (segmentIndex >= 0 && static_cast<size_t>(segmentIndex) < Names.size()) {
+					label << Names[segmentIndex] << ": ";
+				}
+				label << "(" << plotPos.GetX() << ", " << plotPos.GetY() << ")";
+				return label.str();
+			}
+
+		protected:
+
+			Multi_line_plot() : MaxLegend(8), Threads(0), LabelsDirty(true), VerticesDirty(true), Legend(vtkSmartPointer<vtkStringArray>::New()) {
+				std::memset(Bounds, 0, sizeof(Bounds));
+				std::memset(CachedShiftScale, 0, sizeof(CachedShiftScale));
+				this->SetSelectable(false);
+			}
+
+			~Multi_line_plot() override {
+				Release();
+			}
+
+		private:
+
+			Multi_line_plot(const Multi_line_plot&) = delete;
+			void operator=(const Multi_line_plot&) = delete;
+
+			const series_view& X(size_t series) const { return Xs[(Xs.size() == 1) ? 0 : series]; }
+
+			size_t NamedEntries() const { return (Ys.size() <= MaxLegend) ? Ys.size() : MaxLegend - 1; }
+
+			void Release() {
+				for (const float* data : Owned) {
+					delete[] data;
+				}
+				Owned.clear();
+			}
+
+			/* Data bounds and which x views are sorted, per series in parallel then reduced (all views are contiguous here) */
+			void ScanData() {
+
+				const size_t count = Ys.size();
+				std::vector<float> lo(4 * count), hi(4 * count);
+				std::vector<char> filled(count, 0);
+				Sorted.assign(Xs.size(), 1);
+
+				parallel_for(count, Threads, [&](size_t j) {
+					const series_view& x = X(j);
+					const series_view& y = Ys[j];
+					if (y.size == 0) {
+						return;
+					}
+					LOD::min_max(x.data, x.size, lo[4 * j], hi[4 * j]);
+					LOD::min_max(y.data, y.size, lo[4 * j + 1], hi[4 * j + 1]);
+					filled[j] = 1;
+					if (Xs.size() > 1 || j == 0) {
+						for (size_t i = 1; i < x.size; i++) {
+							if (x.data[i] < x.data[i - 1]) {
+								Sorted[(Xs.size() == 1) ? 0 : j] = 0;
+								break;
+							}
+						}
+					}
+				});
+
+				bool first = true;
+				std::memset(Bounds, 0, sizeof(Bounds));
+				for (size_t j = 0; j < count; j++) {
+					if (!filled[j]) {
+						continue;
+					}
+					Bounds[0] = first ? lo[4 * j] : (std::min)(Bounds[0], static_cast<double>(lo[4 * j]));
+					Bounds[1] = first ? hi[4 * j] : (std::max)(Bounds[1], static_cast<double>(hi[4 * j]));
+					Bounds[2] = first ? lo[4 * j + 1] : (std::min)(Bounds[2], static_cast<double>(lo[4 * j + 1]));
+					Bounds[3] = first ? hi[4 * j + 1] : (std::max)(Bounds[3], static_cast<double>(hi[4 * j + 1]));
+					first = false;
+				}
+			}
+
+			/* Segment cache: 2 (shifted/scaled) vertices and 2 colours per segment, every series one after the other */
+			void UpdateVertices() {
+
+				const vtkRectd shift_scale = this->ShiftScale;
+				const double current[4] = { shift_scale.GetX(), shift_scale.GetY(), shift_scale.GetWidth(), shift_scale.GetHeight() };
+				if (!VerticesDirty && std::memcmp(current, CachedShiftScale, sizeof(current)) == 0) {
+					return;
+				}
+				std::memcpy(CachedShiftScale, current, sizeof(current));
+				VerticesDirty = false;
+
+				const size_t count = Ys.size();
+				std::vector<size_t> first(count + 1, 0);
+				for (size_t j = 0; j < count; j++) {
+					first[j + 1] = first[j] + ((Ys[j].size >= 2) ? 2 * (Ys[j].size - 1) : 0);
+				}
+				Vertices.resize(2 * first[count]);
+				VertexColours.resize(4 * first[count]);
+
+				parallel_for(count, Threads, [&](size_t j) {
+					const float* x = X(j).data;
+					const float* y = Ys[j].data;
+					float* vertex = Vertices.data() + 2 * first[j];
+					unsigned char* colour = VertexColours.data() + 4 * first[j];
+					for (size_t i = 0; i + 1 < Ys[j].size; i++) {
+						for (size_t end = i; end <= i + 1; end++) {
+							*vertex++ = static_cast<float>((x[end] + current[0]) * current[2]);
+							*vertex++ = static_cast<float>((y[end] + current[1]) * current[3]);
+							std::memcpy(colour, &Colours[4 * j], 4);
+							colour += 4;
+						}
+					}
+				});
+			}
+
+			std::vector<std::string> Names;
+			std::vector<series_view> Xs, Ys;			// Xs: one shared view or one per series
+			std::vector<float> Block;					// COPY / strided data, series after series
+			std::vector<const float*> Owned;			// TAKE_OWNERSHIP memory, freed with the plot
+			std::vector<char> Sorted;					// Per x view: ascending -> hit-tested
+			std::vector<unsigned char> Colours;			// RGBA per series
+			std::vector<float> Vertices;				// Segment cache (plot coordinates)
+			std::vector<unsigned char> VertexColours;	// RGBA per cached vertex
+			double Bounds[4];
+			double CachedShiftScale[4];
+			size_t MaxLegend;
+			unsigned Threads;
+			bool LabelsDirty, VerticesDirty;
+			vtkSmartPointer<vtkStringArray> Legend;
+		};
+
+		/* =================================================================================================================
+		Plot N number of lines as a single Multi_line_plot (x_pos -> one shared series_view or one per line).
+		LineColour nullptr -> a palette colour per line. False when the data is rejected (see std::cerr) or the headless image isn't written.
+		=================================================================================================================== */
+		inline bool Multi_line_plotter(const std::vector<std::string>& names, const std::vector<series_view>& x_pos, const std::vector<series_view>& data, const char* LineColour = nullptr, Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
+
+			Instrumentation::Scope instrumentation("_2D::Multi_line_plotter");
+
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+			vtkSmartPointer<Multi_line_plot> lines = vtkSmartPointer<Multi_line_plot>::New();
+			if (!lines->SetData(names, x_pos, data, mode)) { return false; }
+			table_timer.stop();
+
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+			lines->SetColours(LineColour);
+			lines->SetWidth(1.0);
+
+			vtkSmartPointer<vtkChartXY> chart = vtkSmartPointer<vtkChartXY>::New();
+			chart->AddPlot(lines);
+			layout.stop();
+			Instrumentation::update_measured(chart.GetPointer());
+
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(chart, default_background, target);
+			}
+
+			// Set up the view
+			vtkSmartPointer<vtkContextView> view = vtkSmartPointer<vtkContextView>::New();
+			view->GetRenderer()->SetBackground(1.0, 1.0, 1.0);
+			view->GetScene()->AddItem(chart);
+
+			// Start interactor and render window
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
+			view->GetRenderWindow()->Render();
+			render_timer.stop();
+			instrumentation.finish();
+			view->GetInteractor()->Initialize();
+			view->GetInteractor()->Start();
+			return true;
+		}
+
+		/* Lines sharing the same X coordinates */
+		inline bool Multi_line_plotter(const std::vector<std::string>& names, series_view x_pos, const std::vector<series_view>& data, const char* LineColour = nullptr, Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
+			return Multi_line_plotter(names, std::vector<series_view>(1, x_pos), data, LineColour, mode, target);
+		}
+
+		/* =================================================================================================================
+		Multi-line creator which adds every line as one plot to the inputted chart (see multiplot_chart_instantiation)
+		================================================================================================================= */
+		inline void Multi_line_plotter(vtkSmartPointer<vtkChartXY>& chart, const std::vector<std::string>& names, const std::vector<series_view>& x_pos, const std::vector<series_view>& data, const char* LineColour, float width, Ingestion mode = COPY) {
+
+			Instrumentation::Scope instrumentation("_2D::Multi_line_plotter");
+
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+			vtkSmartPointer<Multi_line_plot> lines = vtkSmartPointer<Multi_line_plot>::New();
+			if (!lines->SetData(names, x_pos, data, mode)) { return; }
+			table_timer.stop();
+
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+			lines->SetColours(LineColour);
+			lines->SetWidth(width);
+			chart->AddPlot(lines);
+		}
+
+		/* Each row of the C-array block is one line (no copy with BORROW). TAKE_OWNERSHIP means ownership of the whole block. */
+		template<int numPoints, int numLines>
+		void Multi_line_plotter(std::string(&names)[numLines], float(&x_pos)[numPoints], float(&data)[numLines][numPoints], const char* LineColour = nullptr, Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
+
+			std::vector<series_view> rows(numLines);
+			for (int j = 0; j < numLines; j++) {
+				rows[j] = series_view(data[j], numPoints);
+			}
+			Multi_line_plotter(std::vector<std::string>(names, names + numLines), series_view(x_pos, numPoints), rows, LineColour, as_block(mode), target);
+		}
+	}
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------ Level of detail for huge 3D point clouds: Morton ordered (linear) octree ---------------
+ ==================================================================================================*/
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_parallel.h"
+#include "VTK_decimation.h"
+
+/* External modules */
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	namespace LOD {
+
+		/* Progressive level of detail settings passed to _3D::Point_cloud_plotter */
+		struct Cloud_settings {
+
+			bool progressive;			// Off -> every point is drawn every frame
+			size_t interactive_points;	// Points drawn while the camera moves (and the first frame)
+			size_t refine_points;		// Points added per frame while the view is at rest, until all are shown
+			unsigned threads;			// Worker threads for the octree build (0 -> one per hardware thread)
+
+			Cloud_settings(bool progressive = false, size_t interactive_points = 1000000, size_t refine_points = 4000000, unsigned threads = 0)
+				: progressive(progressive), interactive_points(interactive_points), refine_points(refine_points), threads(threads) {}
+		};
+
+		/* 10 bit coordinate -> every third bit of a 30 bit Morton code */
+		inline uint32_t spread_bits(uint32_t v) {
+
+			v &= 0x3FF;
+			v = (v | (v << 16)) & 0x030000FF;
+			v = (v | (v << 8)) & 0x0300F00F;
+			v = (v | (v << 4)) & 0x030C30C3;
+			v = (v | (v << 2)) & 0x09249249;
+			return v;
+		}
+
+		/* Reverse the low "bits" bits of v */
+		inline uint64_t reverse_bits(uint64_t v, unsigned bits) {
+
+			v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+			v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+			v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+			v = ((v >> 8) & 0x00FF00FF00FF00FFULL) | ((v & 0x00FF00FF00FF00FFULL) << 8);
+			v = ((v >> 16) & 0x0000FFFF0000FFFFULL) | ((v & 0x0000FFFF0000FFFFULL) << 16);
+			v = (v >> 32) | (v << 32);
+			return (bits == 0) ? 0 : (v >> (64 - bits));
+		}
+
+		/* Sort in parallel: chunks are sorted on their own then merged pairwise (log2(chunks) passes, each in parallel) */
+		inline void parallel_sort(std::vector<uint64_t>& keys, unsigned threads) {
+
+			const size_t n = keys.size();
+			const size_t chunks = worker_count(threads, n / 65536 + 1);
+			if (chunks <= 1) {
+				std::sort(keys.begin(), keys.end());
+				return;
+			}
+
+			const size_t chunk = (n + chunks - 1) / chunks;
+			parallel_for(chunks, threads, [&](size_t c) {
+				const size_t begin = (std::min)(n, c * chunk);
+				const size_t end = (std::min)(n, begin + chunk);
+				std::sort(keys.begin() + begin, keys.begin() + end);
+			});
+
+			for (size_t width = chunk; width < n; width *= 2) {
+				const size_t pairs = (n + 2 * width - 1) / (2 * width);
+				parallel_for(pairs, threads, [&](size_t p) {
+					const size_t begin = p * 2 * width;
+					const size_t middle = (std::min)(n, begin + width);
+					const size_t end = (std::min)(n, begin + 2 * width);
+					std::inplace_merge(keys.begin() + begin, keys.begin() + middle, keys.begin() + end);
+				});
+			}
+		}
+
+		/* =================================================================================================================
+		Linear octree of a point cloud, built once and in parallel:
+			1. bounds of the cloud (SIMD min/max per chunk)
+			2. each point -> 30 bit Morton code of its cell in a 1024^3 grid (depth 10 octree), sorted with the point index
+			   (points of any octree node are then one run of the sorted list)
+			3. the sorted list is read in bit reversed order, so ANY prefix of the result takes points at even steps along
+			   the Morton curve: roughly one point from every occupied node at the depth the prefix length allows.
+		The points are stored (copied, structure of arrays) in that order, so drawing the first k points of each axis is
+		a spatially even subsample of k points and drawing them all is the full cloud. Clouds of up to 2^34 points.
+		Build memory: 12 bytes per point kept + 8 bytes per point while sorting.
+		================================================================================================================= */
+		class Point_octree {
+
+		public:
+
+			Point_octree(const series_view& x, const series_view& y, const series_view& z, unsigned threads = 0) : count(x.size) {
+
+				const series_view axes[3] = { x, y, z };
+				const size_t chunk = 65536;
+				const size_t chunks = (count + chunk - 1) / chunk;
+
+				// ----- 1. Bounds, one min/max per chunk then reduced -----
+				std::vector<float> lo(3 * chunks), hi(3 * chunks);
+				parallel_for(chunks, threads, [&](size_t c) {
+
+					const size_t begin = c * chunk;
+					const size_t n = (std::min)(chunk, count - begin);
+					for (int axis = 0; axis < 3; axis++) {
+						const series_view& view = axes[axis];
+						if (view.contiguous()) {
+							min_max(view.data + begin, n, lo[3 * c + axis], hi[3 * c + axis]);
+							continue;
+						}
+						float l = view[begin], h = view[begin];
+						for (size_t i = begin + 1; i < begin + n; i++) {
+							l = (std::min)(l, view[i]);
+							h = (std::max)(h, view[i]);
+						}
+						lo[3 * c + axis] = l;
+						hi[3 * c + axis] = h;
+					}
+				});
+
+				float scale[3];
+				for (int axis = 0; axis < 3; axis++) {
+					bounds[2 * axis] = 0.0f;
+					bounds[2 * axis + 1] = 0.0f;
+					for (size_t c = 0; c < chunks; c++) {
+						bounds[2 * axis] = (c == 0) ? lo[3 * c + axis] : (std::min)(bounds[2 * axis], lo[3 * c + axis]);
+						bounds[2 * axis + 1] = (c == 0) ? hi[3 * c + axis] : (std::max)(bounds[2 * axis + 1], hi[3 * c + axis]);
+					}
+					const float extent = bounds[2 * axis + 1] - bounds[2 * axis];
+					scale[axis] = (extent > 0.0f) ? 1023.0f / extent : 0.0f;
+				}
+
+				// ----- 2. Morton code << 34 | index, sorted -----
+				const uint64_t index_mask = (1ULL << 34) - 1;
+				std::vector<uint64_t> keys(count);
+				parallel_for(chunks, threads, [&](size_t c) {
+
+					const size_t begin = c * chunk;
+					const size_t end = (std::min)(count, begin + chunk);
+					for (size_t i = begin; i < end; i++) {
+						uint32_t code = 0;
+						for (int axis = 0; axis < 3; axis++) {
+							const float q = (axes[axis][i] - bounds[2 * axis]) * scale[axis];
+							code |= spread_bits(static_cast<uint32_t>((std::min)((std::max)(q, 0.0f), 1023.0f))) << axis;
+						}
+						keys[i] = (static_cast<uint64_t>(code) << 34) | (i & index_mask);
+					}
+				});
+				parallel_sort(keys, threads);
+
+				// ----- 3. Bit reversed read of the sorted list -----
+				// j runs over the next power of two, positions reverse(j) past the end are skipped. Blocks of j are counted first
+				// so every block knows where its points go and the blocks can be filled in parallel.
+				unsigned bits = 0;
+				while ((1ULL << bits) < count) {
+					bits++;
+				}
+				const uint64_t total = 1ULL << bits;
+				const uint64_t block = (std::min)(total, static_cast<uint64_t>(chunk));
+				const size_t blocks = static_cast<size_t>(total / block);
+
+				std::vector<size_t> starts(blocks + 1, 0);
+				parallel_for(blocks, threads, [&](size_t b) {
+					size_t valid = 0;
+					for (uint64_t j = b * block; j < (b + 1) * block; j++) {
+						valid += (reverse_bits(j, bits) < count) ? 1 : 0;
+					}
+					starts[b + 1] = valid;
+				});
+				for (size_t b = 0; b < blocks; b++) {
+					starts[b + 1] += starts[b];
+				}
+
+				for (int axis = 0; axis < 3; axis++) {
+					ordered[axis].resize(count);
+				}
+				parallel_for(blocks, threads, [&](size_t b) {
+					size_t out = starts[b];
+					for (uint64_t j = b * block; j < (b + 1) * block; j++) {
+						const uint64_t position = reverse_bits(j, bits);
+						if (position >= count) {
+							continue;
+						}
+						const size_t point = static_cast<size_t>(keys[position] & index_mask);
+						for (int axis = 0; axis < 3; axis++) {
+							ordered[axis][out] = axes[axis][point];
+						}
+						out++;
+					}
+				});
+			}
+
+			size_t size() const { return count; }
+
+			/* Axis 0, 1, 2 -> x, y, z in progressive order (the first k of each are an even subsample) */
+			const float* data(int axis) const { return ordered[axis].data(); }
+
+			/* xmin, xmax, ymin, ymax, zmin, zmax */
+			const float* get_bounds() const { return bounds; }
+
+		private:
+
+			size_t count;
+			std::vector<float> ordered[3];
+			float bounds[6];
+		};
+	}
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------------- Render targets: on screen window or headless offscreen PNG/RGBA ---------------
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkContextActor.h>
+#include <vtkContextScene.h>
+#include <vtkContextItem.h>
+#include <vtkChartXYZ.h>
+#include <vtkWindowToImageFilter.h>
+#include <vtkPNGWriter.h>
+#include <vtkUnsignedCharArray.h>
+
+/* Wrapper modules */
+#include "VTK_instrumentation.h"
+
+/* External modules */
+#include <vector>
+#include <string>
+#include <iostream>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	/* Where a standalone plotter (or multiplot_view_window) sends its figure.
+	   WINDOW	-> Interactive window, blocks until closed (the default and the original behaviour).
+	   PNG		-> Render offscreen and write a PNG file. No interactor is created and no display is needed.
+	   RGBA		-> Render offscreen into a caller owned buffer of width * height * 4 bytes (rows bottom to top, as OpenGL reads them).
+	   The offscreen targets only ask VTK for an offscreen render window, so they work with a CPU-only OSMesa build.
+	   Pass a window to render into an existing offscreen window instead of creating one per figure (see the batch renderer). */
+	struct RenderTarget {
+
+		enum Kind {
+			WINDOW, PNG, RGBA
+		};
+
+		Kind kind;
+		int width, height;						// Offscreen size in pixels (the interactive window keeps its own default)
+		std::string path;						// PNG
+		std::vector<unsigned char>* rgba;		// RGBA (resized to width * height * 4)
+		vtkRenderWindow* window;				// Optional offscreen window to reuse
+
+		RenderTarget() : kind(WINDOW), width(640), height(480), rgba(nullptr), window(nullptr) {}
+
+		static RenderTarget Png(const std::string& path, int width = 640, int height = 480) {
+			RenderTarget target;
+			target.kind = PNG;
+			target.path = path;
+			target.width = width;
+			target.height = height;
+			return target;
+		}
+
+		static RenderTarget Rgba(std::vector<unsigned char>& out, int width = 640, int height = 480) {
+			RenderTarget target;
+			target.kind = RGBA;
+			target.rgba = &out;
+			target.width = width;
+			target.height = height;
+			return target;
+		}
+
+		bool offscreen() const { return kind != WINDOW; }
+	};
+
+	/* A render window that never maps to the screen */
+	inline vtkSmartPointer<vtkRenderWindow> offscreen_window(int width, int height) {
+
+		vtkSmartPointer<vtkRenderWindow> window = vtkSmartPointer<vtkRenderWindow>::New();
+		window->SetOffScreenRendering(1);
+		window->SetSize(width, height);
+		return window;
+	}
+
+	/* Read the rendered frame back into the target (PNG file or RGBA buffer) */
+	inline bool capture(vtkRenderWindow* window, const RenderTarget& target) {
+
+		if (target.kind == RenderTarget::RGBA) {
+
+			if (target.rgba == nullptr) {
+				std::cerr << "W_VTK::capture: RGBA target without a buffer\n";
+				return false;
+			}
+
+			// Read straight into the callers buffer: the array wraps it so VTK doesn't allocate its own
+			const vtkIdType bytes = static_cast<vtkIdType>(target.width) * target.height * 4;
+			target.rgba->resize(static_cast<size_t>(bytes));
+
+			vtkSmartPointer<vtkUnsignedCharArray> pixels = vtkSmartPointer<vtkUnsignedCharArray>::New();
+			pixels->SetNumberOfComponents(4);
+			pixels->SetArray(target.rgba->data(), bytes, 1);
+			return window->GetRGBACharPixelData(0, 0, target.width - 1, target.height - 1, 1, pixels) != 0;
+		}
+
+		vtkSmartPointer<vtkWindowToImageFilter> image = vtkSmartPointer<vtkWindowToImageFilter>::New();
+		image->SetInput(window);
+		image->SetInputBufferTypeToRGBA();
+		image->Update();
+
+		vtkSmartPointer<vtkPNGWriter> writer = vtkSmartPointer<vtkPNGWriter>::New();
+		writer->SetFileName(target.path.c_str());
+		writer->SetInputConnection(image->GetOutputPort());
+		writer->Write();
+
+		if (writer->GetErrorCode() != 0) {
+			std::cerr << "W_VTK::capture: could not write " << target.path << "\n";
+			return false;
+		}
+		return true;
+	}
+
+	/* =================================================================================================================
+	Headless scene for a chart (2D or 3D): renderer + vtkContextActor straight on an offscreen window, no vtkContextView and
+	no interactor. The window is created here unless the target carries one to reuse, in which case it is left as found
+	when the scene goes. Kept alive (e.g. by a Figure) the chart can be re-rendered with no set up cost.
+	================================================================================================================= */
+	class Offscreen_scene {
+
+	public:
+
+		Offscreen_scene(vtkContextItem* chart, const double background[3], const RenderTarget& target) : window(target.window) {
+
+			if (!window) {
+				window = offscreen_window(target.width, target.height);
+			}
+			else {
+				window->SetSize(target.width, target.height);
+			}
+
+			// 3D charts don't size themselves to the scene, keep the axes box inside the image (as multiplot_chart_instantiation)
+			vtkChartXYZ* chart3D = vtkChartXYZ::SafeDownCast(chart);
+			if (chart3D) {
+				chart3D->SetGeometry(vtkRectf(5.0f, 5.0f, target.width - 5.0f, target.height - 5.0f));
+			}
+
+			renderer = vtkSmartPointer<vtkRenderer>::New();
+			renderer->SetBackground(background);
+
+			// The context actor draws the scene holding the chart (what vtkContextView sets up for the interactive window)
+			actor = vtkSmartPointer<vtkContextActor>::New();
+			actor->GetScene()->AddItem(chart);
+			renderer->AddActor(actor);
+
+			window->AddRenderer(renderer);
+		}
+
+		~Offscreen_scene() {
+			window->RemoveRenderer(renderer);
+		}
+
+		/* Render a frame and write it to the target */
+		bool render(const RenderTarget& target) {
+
+			Instrumentation::Stage_timer timer(Instrumentation::RENDER);
+			window->Render();
+			return capture(window, target);
+		}
+
+		vtkRenderer* get_renderer() const { return renderer; }
+
+	private:
+
+		Offscreen_scene(const Offscreen_scene&) = delete;
+		Offscreen_scene& operator=(const Offscreen_scene&) = delete;
+
+		vtkSmartPointer<vtkRenderWindow> window;
+		vtkSmartPointer<vtkRenderer> renderer;
+		vtkSmartPointer<vtkContextActor> actor;
+	};
+
+	/* Render a chart headless once (the standalone plotters) */
+	inline bool render_offscreen(vtkContextItem* chart, const double background[3], const RenderTarget& target) {
+
+		Offscreen_scene scene(chart, background, target);
+		return scene.render(target);
+	}
+
+	/* Render a plain renderer (actors, no chart) headless once, e.g. the point cloud and trajectory plotters */
+	inline bool render_offscreen(vtkRenderer* renderer, const RenderTarget& target) {
+
+		vtkSmartPointer<vtkRenderWindow> window = target.window;
+		if (!window) {
+			window = offscreen_window(target.width, target.height);
+		}
+		else {
+			window->SetSize(target.width, target.height);
+		}
+
+		window->AddRenderer(renderer);
+		bool written;
+		{
+			Instrumentation::Stage_timer timer(Instrumentation::RENDER);
+			window->Render();
+			written = capture(window, target);
+		}
+		window->RemoveRenderer(renderer);
+
+		return written;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+/* ==================================================================================================
+ ---------------------- Small threading helpers shared by the wrapper modules -----------------------
+ ==================================================================================================*/
+
+/* External modules */
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	/* Number of worker threads to use: the requested count, or one per hardware thread when 0.
+	   Never more workers than there are work items. */
+	inline unsigned worker_count(unsigned requested, size_t work_items) {
+
+		unsigned workers = requested;
+		if (workers == 0) {
+			workers = std::thread::hardware_concurrency();
+		}
+		if (workers == 0) {
+			workers = 1;	// hardware_concurrency() is allowed to return 0 when it can't tell
+		}
+		if (work_items < workers) {
+			workers = static_cast<unsigned>(work_items);
+		}
+		return (workers == 0) ? 1 : workers;
+	}
+
+	/* Run f(i) for every i in [0, count) across worker threads. Items are handed out one at a time from a shared
+	   counter, so very uneven items (e.g. series of different lengths) still balance. The calling thread works too.
+	   f must not throw. */
+	template<typename Function>
+	void parallel_for(size_t count, unsigned threads, Function f) {
+
+		const unsigned workers = worker_count(threads, count);
+		if (workers <= 1) {
+			for (size_t i = 0; i < count; i++) {
+				f(i);
+			}
+			return;
+		}
+
+		std::atomic<size_t> next(0);
+		auto work = [&]() {
+			for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+				f(i);
+			}
+		};
+
+		std::vector<std::thread> pool;
+		pool.reserve(workers - 1);
+		for (unsigned t = 1; t < workers; t++) {
+			pool.emplace_back(work);
+		}
+		work();
+		for (std::thread& worker : pool) {
+			worker.join();
+		}
+	}
+}
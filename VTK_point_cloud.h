@@ -0,0 +1,330 @@
+#pragma once
+
+/* ==================================================================================================
+ ----------- Point clouds: 3D scatter of millions of points as one vtkPolyData and one actor ---------
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkFloatArray.h>
+#include <vtkSOADataArrayTemplate.h>
+#include <vtkPointGaussianMapper.h>
+#include <vtkActor.h>
+#include <vtkProperty.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkInteractorStyleTrackballCamera.h>
+#include <vtkCommand.h>
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_output.h"
+#include "VTK_colours.h"
+#include "VTK_instrumentation.h"
+#include "VTK_3D_plotter.h"
+#include "VTK_octree.h"
+
+/* External modules */
+#include <cstring>
+#include <memory>
+#include <algorithm>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	/* Interleaved x0,y0,z0,x1,...: three stride 3 float views into one buffer, which starts at x.data (data is only set for float) */
+	inline bool interleaved_xyz(const series_view& x, const series_view& y, const series_view& z) {
+		return x.data != nullptr && x.stride == 3 && y.stride == 3 && z.stride == 3 && y.data == x.data + 1 && z.data == x.data + 2;
+	}
+
+	/* =================================================================================================================
+	x, y, z -> vtkPoints without copying where the layout allows it:
+		separate contiguous axes (e.g. data[spatial_dimensions][numPoints])	-> one vtkSOADataArrayTemplate wrapping the three rows
+		interleaved x0,y0,z0,x1,... (views with stride 3 into one buffer)		-> one 3 component vtkFloatArray wrapping the buffer
+	Both are O(1) for BORROW / TAKE_OWNERSHIP. COPY and any other strided layout are copied into the points' own memory.
+	Ownership follows make_column (TAKE_OWNERSHIP_OF_BLOCK -> the x row owns the block). Sizes must already match.
+	================================================================================================================= */
+	inline vtkSmartPointer<vtkPoints> make_points(const series_view& x, const series_view& y, const series_view& z, Ingestion mode) {
+
+		enum { X_axis, Y_axis, Z_axis, spatial_dimensions };
+
+		const vtkIdType numPoints = static_cast<vtkIdType>(x.size);
+		const series_view axes[spatial_dimensions] = { x, y, z };
+		vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+
+		// Interleaved: the x view already is the AOS array VTK uses natively
+		if (interleaved_xyz(x, y, z) && mode != COPY) {
+
+			vtkSmartPointer<vtkFloatArray> xyz = vtkSmartPointer<vtkFloatArray>::New();
+			xyz->SetNumberOfComponents(spatial_dimensions);
+			if (mode == BORROW) {
+				xyz->SetArray(const_cast<float*>(x.data), numPoints * spatial_dimensions, 1);
+			}
+			else {
+				xyz->SetArray(const_cast<float*>(x.data), numPoints * spatial_dimensions, 0, vtkAbstractArray::VTK_DATA_ARRAY_DELETE);
+			}
+			points->SetData(xyz);
+			Instrumentation::count_column(0);
+			return points;
+		}
+
+		// Separate axes: structure of arrays, one component array per axis
+		vtkSmartPointer<vtkSOADataArrayTemplate<float>> soa = vtkSmartPointer<vtkSOADataArrayTemplate<float>>::New();
+		soa->SetNumberOfComponents(spatial_dimensions);
+
+		const bool wrap = (mode != COPY && x.contiguous() && y.contiguous() && z.contiguous());
+		if (wrap) {
+			for (int axis = 0; axis < spatial_dimensions; axis++) {
+
+				// save = true -> VTK never frees the memory. VTK only reads the points so casting away const is safe here.
+				const Ingestion axisMode = block_row_mode(mode, axis);
+				if (axisMode == BORROW) {
+					soa->SetArray(axis, const_cast<float*>(axes[axis].data), numPoints, true, true);
+				}
+				else {
+					soa->SetArray(axis, const_cast<float*>(axes[axis].data), numPoints, true, false, vtkAbstractArray::VTK_DATA_ARRAY_DELETE);
+				}
+				Instrumentation::count_column(0);
+			}
+		}
+		else {
+			soa->SetNumberOfTuples(numPoints);
+			for (int axis = 0; axis < spatial_dimensions; axis++) {
+
+				float* out = soa->GetComponentArrayPointer(axis);
+				if (axes[axis].contiguous()) {
+					std::memcpy(out, axes[axis].data, numPoints * sizeof(float));
+				}
+				else {
+					for (vtkIdType i = 0; i < numPoints; i++) {
+						out[i] = axes[axis][static_cast<size_t>(i)];
+					}
+				}
+				Instrumentation::count_column(numPoints * sizeof(float));
+			}
+
+			// Contiguous data handed over but copied (COPY never is, strided views are left with the caller as in make_column)
+			for (int axis = 0; axis < spatial_dimensions; axis++) {
+				if (mode != COPY && axes[axis].stride == 1) {
+					release_unwrapped(axes[axis], block_row_mode(mode, axis));
+				}
+			}
+		}
+
+		points->SetData(soa);
+		return points;
+	}
+
+
+	namespace _3D {
+
+		/* ----- Notes -----:
+		The scatter plotters go through vtkChartXYZ + vtkPlotPoints3D, which draws through the 2D context and copies every point
+		into its own list, so it crawls past a few hundred thousand points. Point_cloud_plotter takes the same arguments but
+		builds ONE vtkPolyData over the callers memory (see make_points, no copy for data[spatial_dimensions][numPoints] or
+		interleaved x,y,z) drawn by ONE actor through vtkPointGaussianMapper. With a scale factor of 0 the mapper draws plain
+		points straight from the point array (no vertex cells are built), which keeps 10M+ points interactive on CPU (OSMesa)
+		rendering. width is the point size in pixels.
+		There are no chart axes: the camera is fitted to the cloud and moved with the trackball style.
+		Progressive level of detail (LOD::Cloud_settings(true), interactive window only): the cloud is put in a LOD::Point_octree
+		(built once, in parallel, the callers data is no longer needed afterwards) and only lod.interactive_points of it are drawn
+		while the camera moves. When the view comes to rest lod.refine_points more are added every frame until the full cloud
+		is shown, so interaction stays smooth at any size. Headless targets always draw every point. */
+
+		/* =================================================================================================================
+		Drives the progressive cloud: coarse while the camera moves, refining on a timer while it is at rest.
+		Observes the interactor style (start/end of interaction) and the interactor (timer).
+		================================================================================================================= */
+		class Progressive_cloud : public vtkCommand {
+
+		public:
+
+			static Progressive_cloud* New() { return new Progressive_cloud; }
+
+			/* Points over the octree's progressive order, showing the interactive subsample to start with */
+			vtkSmartPointer<vtkPoints> Initialise(std::unique_ptr<LOD::Point_octree> cloud, const LOD::Cloud_settings& settings) {
+
+				octree = std::move(cloud);
+				lod = settings;
+				soa = vtkSmartPointer<vtkSOADataArrayTemplate<float>>::New();
+				soa->SetNumberOfComponents(spatial_dimensions);
+				points = vtkSmartPointer<vtkPoints>::New();
+				Show((std::min)(lod.interactive_points, octree->size()));
+				points->SetData(soa);
+				return points;
+			}
+
+			/* Start refining (call after the interactor is initialised) */
+			void Attach(vtkRenderWindowInteractor* windowInteractor, vtkInteractorStyle* style) {
+
+				interactor = windowInteractor;
+				style->AddObserver(vtkCommand::StartInteractionEvent, this);
+				style->AddObserver(vtkCommand::EndInteractionEvent, this);
+				interactor->AddObserver(vtkCommand::TimerEvent, this);
+				Refine();
+			}
+
+			/* Bounds of the whole cloud (xmin, xmax, ymin, ymax, zmin, zmax) */
+			const float* GetBounds() const { return octree->get_bounds(); }
+
+			void Execute(vtkObject*, unsigned long eventId, void* callData) override {
+
+				if (eventId == vtkCommand::StartInteractionEvent) {
+					// Camera moving: back to the coarse subsample (a prefix, so nothing is rebuilt)
+					StopRefining();
+					Show((std::min)(lod.interactive_points, octree->size()));
+				}
+				else if (eventId == vtkCommand::EndInteractionEvent) {
+					Refine();
+				}
+				else if (eventId == vtkCommand::TimerEvent && callData && *static_cast<int*>(callData) == timer) {
+					Show((std::min)(shown + lod.refine_points, octree->size()));
+					interactor->Render();
+					if (shown == octree->size()) {
+						StopRefining();
+					}
+				}
+			}
+
+		private:
+
+			Progressive_cloud() : interactor(nullptr), timer(-1), shown(0) {}
+
+			/* Draw the first count points: the axes are rewrapped at the new length, O(1) */
+			void Show(size_t count) {
+
+				shown = count;
+				for (int axis = 0; axis < spatial_dimensions; axis++) {
+					soa->SetArray(axis, const_cast<float*>(octree->data(axis)), static_cast<vtkIdType>(count), true, true);
+				}
+				soa->Modified();
+				points->Modified();
+			}
+
+			void Refine() {
+				if (timer < 0 && shown < octree->size()) {
+					timer = interactor->CreateRepeatingTimer(1);
+				}
+			}
+
+			void StopRefining() {
+				if (timer >= 0) {
+					interactor->DestroyTimer(timer);
+					timer = -1;
+				}
+			}
+
+			std::unique_ptr<LOD::Point_octree> octree;
+			LOD::Cloud_settings lod;
+			vtkSmartPointer<vtkSOADataArrayTemplate<float>> soa;
+			vtkSmartPointer<vtkPoints> points;
+			vtkRenderWindowInteractor* interactor;		// Owns this (observer), so a raw pointer
+			int timer;
+			size_t shown;
+		};
+
+		/*=================================================================================================================
+		Plot a point cloud in 3D. False when the axes are rejected (see std::cerr) or the headless image isn't written.
+		=================================================================================================================== */
+		inline bool Point_cloud_plotter(series_view x, series_view y, series_view z, const char* PointColourName, const char* BackgroundColour, float width, Ingestion mode = BORROW, const LOD::Cloud_settings& lod = LOD::Cloud_settings(), const RenderTarget& target = RenderTarget()) {
+
+			Instrumentation::Scope instrumentation("_3D::Point_cloud_plotter");
+			if (!axis_size_check(x, y, z)) { return false; }
+
+			// Named colours
+			const Colour_table* colors = named_colours();
+
+			vtkSmartPointer<vtkPolyData> cloud = vtkSmartPointer<vtkPolyData>::New();
+
+			// Progressive: points over the octree (the callers data is copied into it)
+			vtkSmartPointer<Progressive_cloud> progressive;
+			if (lod.progressive && !target.offscreen() && x.size > lod.interactive_points) {
+				Instrumentation::Stage_timer conversion(Instrumentation::CONVERSION);
+				progressive = vtkSmartPointer<Progressive_cloud>::New();
+				cloud->SetPoints(progressive->Initialise(std::unique_ptr<LOD::Point_octree>(new LOD::Point_octree(x, y, z, lod.threads)), lod));
+				// Handed over data is freed now the octree has its copy: an interleaved buffer once through x (as make_points
+				// adopts it), other strided views stay the caller's (see make_column)
+				if (interleaved_xyz(x, y, z)) {
+					release_unwrapped(x, mode);
+				}
+				else {
+					const series_view axes[spatial_dimensions] = { x, y, z };
+					for (int axis = 0; axis < spatial_dimensions; axis++) {
+						if (axes[axis].stride == 1) {
+							release_unwrapped(axes[axis], block_row_mode(mode, axis));
+						}
+					}
+				}
+			}
+
+			// Otherwise points straight over the data
+			else {
+				Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+				cloud->SetPoints(make_points(x, y, z, mode));
+			}
+
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+
+			// Scale factor 0 -> plain points of the actor's point size, no splats and no vertex cells needed
+			vtkSmartPointer<vtkPointGaussianMapper> mapper = vtkSmartPointer<vtkPointGaussianMapper>::New();
+			mapper->SetInputData(cloud);
+			mapper->SetScaleFactor(0.0);
+			mapper->SetEmissive(0);
+			mapper->ScalarVisibilityOff();
+
+			vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+			actor->SetMapper(mapper);
+			actor->GetProperty()->SetColor(colors->GetColor3d(PointColourName).GetData());
+			actor->GetProperty()->SetPointSize(width);
+
+			vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+			renderer->AddActor(actor);
+			renderer->SetBackground(colors->GetColor3d(BackgroundColour).GetData());
+			renderer->ResetCamera();
+			if (progressive) {
+				// Fit the camera to the whole cloud, not the first subsample
+				const float* b = progressive->GetBounds();
+				renderer->ResetCamera(b[0], b[1], b[2], b[3], b[4], b[5]);
+			}
+			layout.stop();
+
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(renderer, target);
+			}
+
+			vtkSmartPointer<vtkRenderWindow> window = vtkSmartPointer<vtkRenderWindow>::New();
+			window->SetSize(640, 480);
+			window->AddRenderer(renderer);
+
+			vtkSmartPointer<vtkRenderWindowInteractor> interactor = vtkSmartPointer<vtkRenderWindowInteractor>::New();
+			vtkSmartPointer<vtkInteractorStyleTrackballCamera> style = vtkSmartPointer<vtkInteractorStyleTrackballCamera>::New();
+			interactor->SetInteractorStyle(style);
+			interactor->SetRenderWindow(window);
+
+			// Render the scene
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
+			window->Render();
+			render_timer.stop();
+			instrumentation.finish();
+			interactor->Initialize();
+			if (progressive) {
+				progressive->Attach(interactor, style);
+			}
+			interactor->Start();
+			return true;
+		}
+
+		/* Static memory variant: the axis rows are wrapped as they are. The call blocks until the window is closed (or the image
+		   is written), so the array outlives the plot and BORROW is the default here. */
+		template <int numPoints>
+		void Point_cloud_plotter(float(&data)[spatial_dimensions][numPoints], const char* PointColourName, const char* BackgroundColour, float width, Ingestion mode = BORROW, const LOD::Cloud_settings& lod = LOD::Cloud_settings(), const RenderTarget& target = RenderTarget()) {
+
+			Point_cloud_plotter(series_view(data[X_axis], numPoints), series_view(data[Y_axis], numPoints), series_view(data[Z_axis], numPoints), PointColourName, BackgroundColour, width, as_block(mode), lod, target);
+		}
+	}
+}
@@ -0,0 +1,426 @@
+#pragma once
+
+/* ==================================================================================================
+ --------------- Render thread: figure + interactor on their own thread, fed through a queue --------
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkCommand.h>
+#include <vtkContextView.h>
+#include <vtkRenderWindowInteractor.h>
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_figure.h"
+
+/* External modules */
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <cstring>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	/* =================================================================================================================
+	Unbounded lock-free multi producer / single consumer queue (Vyukov's intrusive MPSC list).
+	push is one allocation and one atomic exchange from any thread and never waits on the consumer or other producers.
+	pop is consumer only. A push that is half way through (exchanged but not linked) is seen by the next pop instead.
+	================================================================================================================= */
+	template<typename T>
+	class Mpsc_queue {
+
+	public:
+
+		Mpsc_queue() : head(new Node()), tail(head.load(std::memory_order_relaxed)) {}
+
+		~Mpsc_queue() {
+			T drop;
+			while (pop(drop)) {}
+			delete tail;
+		}
+
+		/* Any thread */
+		void push(T value) {
+
+			Node* node = new Node();
+			node->value = std::move(value);
+			Node* previous = head.exchange(node, std::memory_order_acq_rel);
+			previous->next.store(node, std::memory_order_release);
+		}
+
+		/* Consumer thread only. False when empty. */
+		bool pop(T& out) {
+
+			Node* next = tail->next.load(std::memory_order_acquire);
+			if (next == nullptr) {
+				return false;
+			}
+			out = std::move(next->value);
+			delete tail;
+			tail = next;	// Becomes the new stub
+			return true;
+		}
+
+	private:
+
+		Mpsc_queue(const Mpsc_queue&) = delete;
+		Mpsc_queue& operator=(const Mpsc_queue&) = delete;
+
+		struct Node {
+			std::atomic<Node*> next;
+			T value;
+			Node() : next(nullptr) {}
+		};
+
+		std::atomic<Node*> head;	// Producers push here
+		Node* tail;					// Consumer pops here (the stub: its value is already taken)
+	};
+
+
+	/* =================================================================================================================
+	Frame rate governor: decides when a live view may redraw.
+	 - At most max_fps frames per second.
+	 - At most max_load of the time spent rendering: when a frame takes longer than the frame interval allows, the next one
+	   waits in proportion (e.g. max_load 0.5 -> a 30 ms frame is followed by at least 30 ms without rendering).
+	So the CPU spent drawing stays bounded whatever rate the data arrives at; updates in between are coalesced by the caller.
+	Usable on its own for a hand written loop:  if (governor.due()) { governor.frame_started(); figure.render(); governor.frame_finished(); }
+	================================================================================================================= */
+	class Frame_governor {
+
+	public:
+
+		typedef std::chrono::steady_clock clock;
+
+		explicit Frame_governor(double max_fps = 60.0, double max_load = 0.5) : next_due(clock::now()) {
+			set_max_fps(max_fps);
+			set_max_load(max_load);
+		}
+
+		/* Any thread */
+		void set_max_fps(double max_fps) { interval_ns.store(static_cast<long long>(1.0e9 / (max_fps > 0.0 ? max_fps : 1.0)), std::memory_order_relaxed); }
+		void set_max_load(double max_load) { load.store((max_load > 0.0 && max_load <= 1.0) ? max_load : 1.0, std::memory_order_relaxed); }
+		double max_fps() const { return 1.0e9 / interval_ns.load(std::memory_order_relaxed); }
+
+		/* May a frame be drawn now? (render thread) */
+		bool due(clock::time_point now = clock::now()) const { return now >= next_due; }
+
+		void frame_started(clock::time_point now = clock::now()) {
+
+			// Keep the cadence, but don't try to catch up frames that were missed
+			next_due += std::chrono::nanoseconds(interval_ns.load(std::memory_order_relaxed));
+			if (next_due < now) {
+				next_due = now;
+			}
+			started = now;
+		}
+
+		void frame_finished(clock::time_point now = clock::now()) {
+
+			// Backpressure: slow frames push the next one back so rendering stays under max_load
+			const double max_load = load.load(std::memory_order_relaxed);
+			const clock::duration took = now - started;
+			const clock::time_point rested = now + std::chrono::duration_cast<clock::duration>(took * ((1.0 - max_load) / max_load));
+			if (rested > next_due) {
+				next_due = rested;
+			}
+		}
+
+	private:
+
+		std::atomic<long long> interval_ns;
+		std::atomic<double> load;
+		clock::time_point next_due;
+		clock::time_point started;
+	};
+
+	/* What a render thread did with what it was given (all counts since it started) */
+	struct Render_counters {
+		unsigned long long submitted;		// Updates accepted by post / set_series
+		unsigned long long applied;			// Updates that reached the figure
+		unsigned long long coalesced;		// Series updates replaced by a newer one for the same series before they were applied
+		unsigned long long frames;			// Frames rendered
+		unsigned long long frames_dropped;	// Ticks with changes waiting that the governor held back (the changes go in a later frame)
+	};
+
+
+	/* ----- Notes -----:
+	The plotters (and Figure::show) run the interactor on the callers thread, so a solver stops until the window is closed.
+	A Render_thread builds a Figure on a thread of its own and runs the interactor (or, for headless targets, a frame loop)
+	there. Every other thread only talks to it through a lock-free queue, so producers never wait on a frame:
+		Render_thread<_2D::Figure> live(
+			[] { return new _2D::Figure("White", true); },			// Built on the render thread (VTK objects stay on it)
+			[&](_2D::Figure& figure) { figure.add_line("T", x, T); });
+		for (each timestep) {
+			solve(T);
+			live.set_series(0, x, T);		// Copies x and T, queues the swap and returns straight away
+		}
+		live.wait();						// Or let the destructor close the window
+	Every poll (poll_ms) the render thread drains the queue. post() tasks are applied in order, then for each series only the
+	newest set_series is applied (older ones are coalesced, they would never have been seen). A frame is drawn when something
+	changed and the Frame_governor allows it, otherwise the frame is dropped and the changes wait for the next allowed one.
+	So data arriving at kHz costs a queue push per update and at most max_fps renders. See counters(). */
+	template<typename Figure>
+	class Render_thread {
+
+	public:
+
+		typedef std::function<void(Figure&)> Task;
+		typedef std::function<Figure*()> Builder;
+
+		/* make -> new figure (owned by the render thread), setup -> first series etc.
+		   max_fps -> redraw cap (see Frame_governor), poll_ms -> how often queued updates are picked up */
+		Render_thread(Builder make, Task setup = Task(), double max_fps = 60.0, unsigned poll_ms = 4)
+			: poll_ms(poll_ms), governor(max_fps), stopping(false), running(true) {
+
+			thread = std::thread(&Render_thread::run, this, make, setup);
+		}
+
+		/* Closes the window (or stops the frame loop) and joins */
+		~Render_thread() {
+			close();
+		}
+
+		/* Queue a change to the figure (any thread, never blocks). False once the window has been closed. */
+		bool post(Task task) {
+			return push(no_series, std::move(task));
+		}
+
+		/* Queue new data for series "id" (x, y for 2D figures, x, y, z for 3D). The views are copied here, on the callers thread,
+		   so the caller's memory is free again as soon as this returns. The render thread swaps the copies in without copying.
+		   Only the newest update per series is applied each frame. */
+		template<typename... Views>
+		bool set_series(size_t id, const Views&... views) {
+
+			std::vector<std::vector<float>> copies = { copy_of(views)... };
+			return push(id, [this, id, copies = std::move(copies)](Figure& figure) mutable {
+				apply_series(figure, id, copies, std::index_sequence_for<Views...>());
+			});
+		}
+
+		/* Block until the user closes the window (headless: until close) */
+		void wait() {
+			if (thread.joinable()) {
+				thread.join();
+			}
+		}
+
+		/* Stop from any thread and join */
+		void close() {
+			stopping.store(true, std::memory_order_release);
+			wait();
+		}
+
+		/* False once the window has been closed */
+		bool is_running() const { return running.load(std::memory_order_acquire); }
+
+		/* Change the redraw cap / load (any thread) */
+		Frame_governor& get_governor() { return governor; }
+
+		/* Snapshot of the counters (any thread) */
+		Render_counters counters() const {
+			Render_counters out;
+			out.submitted = submitted.load(std::memory_order_relaxed);
+			out.applied = applied.load(std::memory_order_relaxed);
+			out.coalesced = coalesced.load(std::memory_order_relaxed);
+			out.frames = frames.load(std::memory_order_relaxed);
+			out.frames_dropped = frames_dropped.load(std::memory_order_relaxed);
+			return out;
+		}
+
+	private:
+
+		Render_thread(const Render_thread&) = delete;
+		Render_thread& operator=(const Render_thread&) = delete;
+
+		static const size_t no_series = static_cast<size_t>(-1);
+
+		/* Queue entry: which series it updates (no_series for post) */
+		struct Message {
+			size_t series;
+			Task task;
+		};
+
+		/* Interactor timer: one poll per tick */
+		class Tick : public vtkCommand {
+
+		public:
+
+			static Tick* New() { return new Tick; }
+
+			Render_thread* owner;
+			Figure* figure;
+
+			void Execute(vtkObject* caller, unsigned long, void*) override {
+
+				if (owner->stopping.load(std::memory_order_acquire)) {
+					static_cast<vtkRenderWindowInteractor*>(caller)->TerminateApp();
+					return;
+				}
+				owner->poll(*figure);
+			}
+
+		private:
+
+			Tick() : owner(nullptr), figure(nullptr) {}
+		};
+
+		bool push(size_t series, Task task) {
+
+			if (!running.load(std::memory_order_acquire)) {
+				return false;
+			}
+			Message message;
+			message.series = series;
+			message.task = std::move(task);
+			queue.push(std::move(message));
+			submitted.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		static std::vector<float> copy_of(const series_view& view) {
+
+			std::vector<float> copy(view.size);
+			if (view.contiguous() && view.size > 0) {
+				std::memcpy(copy.data(), view.data, view.size * sizeof(float));
+			}
+			else {
+				for (size_t i = 0; i < view.size; i++) {
+					copy[i] = view[i];
+				}
+			}
+			return copy;
+		}
+
+		/* Render thread: the figure borrows the copies, which are kept here until the next update for the series replaces them */
+		template<size_t... Axis>
+		void apply_series(Figure& figure, size_t id, std::vector<std::vector<float>>& copies, std::index_sequence<Axis...>) {
+
+			if (!figure.set_series(id, series_view(copies[Axis])..., BORROW)) {
+				return;
+			}
+			if (held.size() <= id) {
+				held.resize(id + 1);
+			}
+			held[id].swap(copies);		// The previous data goes with the task
+		}
+
+		/* Drain the queue (coalescing series updates), then draw if anything changed and the governor allows it */
+		void poll(Figure& figure) {
+
+			unsigned long long applied_now = 0, coalesced_now = 0;
+
+			Message message;
+			while (queue.pop(message)) {
+
+				if (message.series == no_series) {
+					message.task(figure);
+					applied_now++;
+					continue;
+				}
+
+				// Newest update per series wins
+				if (latest.size() <= message.series) {
+					latest.resize(message.series + 1);
+				}
+				if (latest[message.series]) {
+					coalesced_now++;
+				}
+				else {
+					touched.push_back(message.series);
+				}
+				latest[message.series] = std::move(message.task);
+			}
+			message.task = Task();		// Don't keep the last update's data alive until the next poll
+
+			for (size_t id : touched) {
+				latest[id](figure);
+				latest[id] = Task();
+				applied_now++;
+			}
+			touched.clear();
+
+			applied.fetch_add(applied_now, std::memory_order_relaxed);
+			coalesced.fetch_add(coalesced_now, std::memory_order_relaxed);
+			if (applied_now > 0) {
+				dirty = true;
+			}
+
+			if (!dirty) {
+				return;
+			}
+			if (!governor.due()) {
+				frames_dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			draw(figure);
+		}
+
+		void draw(Figure& figure) {
+
+			governor.frame_started();
+			figure.render();
+			governor.frame_finished();
+			dirty = false;
+			frames.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void run(Builder make, Task setup) {
+
+			{
+				// Everything VTK is made, used and destroyed on this thread
+				std::unique_ptr<Figure> figure(make());
+				if (setup) {
+					setup(*figure);
+				}
+				poll(*figure);
+				if (frames.load(std::memory_order_relaxed) == 0) {
+					draw(*figure);
+				}
+
+				vtkContextView* view = figure->get_view();
+				if (view) {
+					vtkSmartPointer<Tick> tick = vtkSmartPointer<Tick>::New();
+					tick->owner = this;
+					tick->figure = figure.get();
+
+					vtkRenderWindowInteractor* interactor = view->GetInteractor();
+					interactor->Initialize();
+					interactor->AddObserver(vtkCommand::TimerEvent, tick);
+					interactor->CreateRepeatingTimer(poll_ms);
+					interactor->Start();
+				}
+				else {
+					// Headless: every allowed frame goes to the target
+					while (!stopping.load(std::memory_order_acquire)) {
+						poll(*figure);
+						std::this_thread::sleep_for(std::chrono::milliseconds(poll_ms));
+					}
+				}
+				latest.clear();
+				held.clear();
+			}
+			running.store(false, std::memory_order_release);
+		}
+
+		unsigned poll_ms;
+		Frame_governor governor;
+		std::atomic<bool> stopping;
+		std::atomic<bool> running;
+		std::atomic<unsigned long long> submitted{ 0 }, applied{ 0 }, coalesced{ 0 }, frames{ 0 }, frames_dropped{ 0 };
+		Mpsc_queue<Message> queue;
+
+		// Render thread only
+		bool dirty = false;										// Changes not drawn yet
+		std::vector<Task> latest;								// Newest pending update per series
+		std::vector<size_t> touched;							// Series with an update in latest
+		std::vector<std::vector<std::vector<float>>> held;		// Data the figure borrows, per series
+		std::thread thread;										// Last, so everything above exists before it starts
+	};
+}
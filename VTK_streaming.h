@@ -0,0 +1,317 @@
+#pragma once
+
+/* ==================================================================================================
+ ---------------- Streaming series: live data appended to a 2D/3D chart through a ring buffer -------
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+#include <vtkChartXY.h>
+#include <vtkChartXYZ.h>
+#include <vtkPlot.h>
+#include <vtkPlotPoints.h>
+#include <vtkPlotLine3D.h>
+#include <vtkPlotPoints3D.h>
+#include <vtkTable.h>
+#include <vtkFloatArray.h>
+#include <vtkPen.h>
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_colours.h"
+
+/* External modules */
+#include <vector>
+#include <string>
+#include <algorithm>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	/* =================================================================================================================
+	Fixed capacity ring buffer of floats stored twice over (mirrored). Every sample is written at i and i + capacity, so
+	the newest size() samples are always ONE contiguous run that a vtkFloatArray can borrow directly (no unwrapping copy).
+	Appending a batch of n samples is O(n) (2n writes), whatever the capacity.
+	================================================================================================================= */
+	class Ring_buffer {
+
+	public:
+
+		explicit Ring_buffer(size_t capacity) : buffer(2 * capacity), cap(capacity), next(0), count(0) {}
+
+		/* Append a batch. Only the newest capacity() samples are kept, so at most that many are written. */
+		void append(const series_view& values) {
+
+			size_t first = 0;
+			if (values.size > cap) {
+				first = values.size - cap;
+			}
+			for (size_t i = first; i < values.size; i++) {
+				const float v = values[i];
+				buffer[next] = v;
+				buffer[next + cap] = v;
+				next = (next + 1 == cap) ? 0 : next + 1;
+			}
+			count = (std::min)(count + (values.size - first), cap);
+		}
+
+		void clear() { next = 0; count = 0; }
+
+		/* Oldest -> newest samples, contiguous */
+		const float* data() const { return buffer.data() + next + cap - count; }
+		size_t size() const { return count; }
+		size_t capacity() const { return cap; }
+
+	private:
+
+		std::vector<float> buffer;	// 2 * capacity
+		size_t cap;
+		size_t next;				// Where the next sample goes (in [0, capacity))
+		size_t count;
+	};
+
+	/* Range of the samples appended since the axes were last fitted. Widening it is O(batch), so a stream only asks the
+	   chart for new bounds (a pass over every plot's points) when a batch lands outside what the axes already show. */
+	class Stream_bounds {
+
+	public:
+
+		Stream_bounds() : lo(0.0f), hi(0.0f), empty(true) {}
+
+		/* True when a value is outside the range (NaNs are skipped), which then grows to include it */
+		bool widen(const series_view& values) {
+
+			bool grew = false;
+			for (size_t i = 0; i < values.size; i++) {
+				const float v = values[i];
+				if (empty) {
+					if (v == v) {
+						lo = hi = v;
+						empty = false;
+						grew = true;
+					}
+					continue;
+				}
+				if (v < lo) {
+					lo = v;
+					grew = true;
+				}
+				if (v > hi) {
+					hi = v;
+					grew = true;
+				}
+			}
+			return grew;
+		}
+
+		/* Refit to the samples a ring holds now */
+		void reset(const Ring_buffer& ring) {
+			empty = true;
+			widen(series_view(ring.data(), ring.size()));
+		}
+
+	private:
+
+		float lo, hi;
+		bool empty;
+	};
+
+	/* Point a collumn at the current ring window: O(1), the collumn borrows the ring's memory */
+	inline void wrap_ring(vtkFloatArray* column, const Ring_buffer& ring) {
+
+		column->SetArray(const_cast<float*>(ring.data()), static_cast<vtkIdType>(ring.size()), 1);
+		column->Modified();
+	}
+
+
+	namespace _2D {
+
+		/* =================================================================================================================
+		Streaming line (or scatter) attached to a vtkChartXY. Batches are appended into fixed capacity ring buffers that the
+		plot's collumns borrow, so an append is O(batch): no vtkTable rebuild and only this plot's input is marked modified.
+		With autoscale the chart's bounds are only recalculated when a batch goes outside the range appended so far, so the
+		axes grow with the data but don't shrink as old samples leave the ring: fit() refits them to the ring's window.
+		The series must be kept alive while the chart is displayed (its ring buffers back the plot). If it is destroyed first
+		it takes its plot off the chart.
+		================================================================================================================= */
+		class Streaming_series {
+
+		public:
+
+			Streaming_series(vtkSmartPointer<vtkChartXY>& chart, size_t capacity, const std::string& name, const char* LineColour, float width, int plotType = vtkChart::LINE, bool autoscale = true)
+				: chart(chart.GetPointer()), xRing(capacity), yRing(capacity), autoscale(autoscale) {
+
+				// Collumns borrow the ring windows (empty to start with). NAMES MATTER, see Line_plotter.
+				X = vtkSmartPointer<vtkFloatArray>::New();
+				X->SetName("X-axis");
+				Y = vtkSmartPointer<vtkFloatArray>::New();
+				Y->SetName(name.c_str());
+
+				table = vtkSmartPointer<vtkTable>::New();
+				table->AddColumn(X);
+				table->AddColumn(Y);
+
+				// Named colours
+				const Colour_table* colors = named_colours();
+
+				plot = chart->AddPlot(plotType);
+				plot->SetInputData(table, 0, 1);
+				plot->GetPen()->SetColorF(colors->GetColor3d(LineColour).GetData());
+				plot->SetWidth(width);
+			}
+
+			~Streaming_series() {
+				if (chart) {
+					chart->RemovePlotInstance(plot);
+				}
+			}
+
+			/* Append a batch of samples (x and y the same size) */
+			void append(const series_view& x, const series_view& y) {
+
+				if (x.size != y.size) {
+					return;
+				}
+				xRing.append(x);
+				yRing.append(y);
+				wrap_ring(X, xRing);
+				wrap_ring(Y, yRing);
+				table->Modified();
+
+				// Only samples outside the range seen so far need new axes
+				const bool grew = xBounds.widen(x) | yBounds.widen(y);
+				if (autoscale && grew && chart) {
+					chart->RecalculateBounds();
+				}
+			}
+
+			void append(float x, float y) {
+				append(series_view(&x, 1), series_view(&y, 1));
+			}
+
+			/* Fit the axes to the samples in the ring now (O(capacity)) */
+			void fit() {
+				xBounds.reset(xRing);
+				yBounds.reset(yRing);
+				if (chart) {
+					chart->RecalculateBounds();
+				}
+			}
+
+			size_t size() const { return yRing.size(); }
+			size_t capacity() const { return yRing.capacity(); }
+			vtkPlot* get_plot() const { return plot; }
+
+		private:
+
+			Streaming_series(const Streaming_series&) = delete;
+			Streaming_series& operator=(const Streaming_series&) = delete;
+
+			vtkWeakPointer<vtkChartXY> chart;
+			vtkPlot* plot;		// Owned by the chart
+			vtkSmartPointer<vtkTable> table;
+			vtkSmartPointer<vtkFloatArray> X, Y;
+			Ring_buffer xRing, yRing;
+			Stream_bounds xBounds, yBounds;		// What the axes were fitted to
+			bool autoscale;
+		};
+	}
+
+
+	namespace _3D {
+
+		/* =================================================================================================================
+		Streaming 3D line (or scatter) attached to a vtkChartXYZ. Same ring buffers and autoscale rule as the 2D series.
+		Note: vtkPlot3D copies its table into its own point list in SetInputData, so on top of the O(batch) append VTK does one
+		O(capacity) pass per append. There is no way round that short of a different 3D backend.
+		================================================================================================================= */
+		class Streaming_series {
+
+		public:
+
+			Streaming_series(vtkSmartPointer<vtkChartXYZ>& chart, size_t capacity, const char* LineColourName, float width, bool points = false, bool autoscale = true)
+				: chart(chart.GetPointer()), xRing(capacity), yRing(capacity), zRing(capacity), autoscale(autoscale) {
+
+				X = vtkSmartPointer<vtkFloatArray>::New();
+				X->SetName("X");
+				Y = vtkSmartPointer<vtkFloatArray>::New();
+				Y->SetName("Y");
+				Z = vtkSmartPointer<vtkFloatArray>::New();
+				Z->SetName("Z");
+
+				table = vtkSmartPointer<vtkTable>::New();
+				table->AddColumn(X);
+				table->AddColumn(Y);
+				table->AddColumn(Z);
+
+				// Named colours
+				const Colour_table* colors = named_colours();
+
+				if (points) {
+					plot = vtkSmartPointer<vtkPlotPoints3D>::New();
+				}
+				else {
+					plot = vtkSmartPointer<vtkPlotLine3D>::New();
+				}
+				plot->GetPen()->SetColorF(colors->GetColor3d(LineColourName).GetData());
+				plot->GetPen()->SetWidth(width);
+				chart->AddPlot(plot);
+			}
+
+			/* Append a batch of samples (x, y and z the same size) */
+			void append(const series_view& x, const series_view& y, const series_view& z) {
+
+				if (x.size != y.size || x.size != z.size) {
+					return;
+				}
+				xRing.append(x);
+				yRing.append(y);
+				zRing.append(z);
+				wrap_ring(X, xRing);
+				wrap_ring(Y, yRing);
+				wrap_ring(Z, zRing);
+				table->Modified();
+
+				// vtkPlot3D only reads its input here
+				plot->SetInputData(table);
+				const bool grew = xBounds.widen(x) | yBounds.widen(y) | zBounds.widen(z);
+				if (autoscale && grew && chart) {
+					chart->RecalculateBounds();
+				}
+			}
+
+			void append(float x, float y, float z) {
+				append(series_view(&x, 1), series_view(&y, 1), series_view(&z, 1));
+			}
+
+			/* Fit the axes to the samples in the ring now (O(capacity)) */
+			void fit() {
+				xBounds.reset(xRing);
+				yBounds.reset(yRing);
+				zBounds.reset(zRing);
+				if (chart) {
+					chart->RecalculateBounds();
+				}
+			}
+
+			size_t size() const { return xRing.size(); }
+			size_t capacity() const { return xRing.capacity(); }
+			vtkPlot3D* get_plot() const { return plot; }
+
+		private:
+
+			Streaming_series(const Streaming_series&) = delete;
+			Streaming_series& operator=(const Streaming_series&) = delete;
+
+			vtkWeakPointer<vtkChartXYZ> chart;
+			vtkSmartPointer<vtkPlot3D> plot;
+			vtkSmartPointer<vtkTable> table;
+			vtkSmartPointer<vtkFloatArray> X, Y, Z;
+			Ring_buffer xRing, yRing, zRing;
+			Stream_bounds xBounds, yBounds, zBounds;
+			bool autoscale;
+		};
+	}
+}
@@ -0,0 +1,367 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------ Surfaces: z = f(x, y) over a grid as one strip mesh, coloured by height ----------------
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPointData.h>
+#include <vtkCellArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkFloatArray.h>
+#include <vtkSOADataArrayTemplate.h>
+#include <vtkLookupTable.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkActor.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkInteractorStyleTrackballCamera.h>
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_output.h"
+#include "VTK_colours.h"
+#include "VTK_instrumentation.h"
+#include "VTK_parallel.h"
+#include "VTK_decimation.h"
+#include "VTK_3D_plotter.h"
+
+/* External modules */
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	namespace _3D {
+
+		/* ----- Notes -----:
+		vtkChartXYZ draws through the 2D context and copies every point, so a grid of millions of nodes as scatter points
+		crawls. A Surface is ONE vtkPolyData drawn by ONE actor:
+			x, y	-> the grid's axes: x has cols values (along a row), y has rows values
+			z		-> rows * cols heights, row major (z[j * cols + i] is at x[i], y[j])
+			points	-> vtkSOADataArrayTemplate: x and y expanded to the grid once, z WRAPPED with BORROW / TAKE_OWNERSHIP
+					   (no copy for contiguous float data, other value types are converted once per update). A Surface
+					   outlives the call so it COPIES by default, Surface_plotter BORROWS. x / y are always expanded into
+					   the Surface's own memory, handed over (TAKE_OWNERSHIP) they are freed once expanded.
+			cells	-> one triangle strip per pair of rows, built once (in parallel)
+			colours	-> the same z memory wrapped again as the point scalars, mapped through a colour map lookup table
+		set_z swaps new heights in: only the z component and the scalars are rewrapped and the colour range rescanned, the
+		points' x / y and the strips are left as they are. Keep a Surface for animations (as a Figure), Surface_plotter is
+		the one call version. There are no axes: the camera is fitted to the surface and moved with the trackball style.
+		Heights must be finite (NaN breaks the colour range). Normals are not computed (VTK shades the strips per facet). */
+
+		class Surface {
+
+		public:
+
+			Surface(series_view x, series_view y, series_view z, Colour_map map = VIRIDIS, const char* BackgroundColour = "White", Ingestion mode = COPY, const RenderTarget& target = RenderTarget())
+				: target(target), rows(y.size), cols(x.size), autorange(true), ready(false) {
+
+				if (!grid_size_check("Surface", z.size)) { return; }
+				if (rows < 2 || cols < 2) {
+					std::cerr << "W_VTK::_3D::Surface: the grid needs at least 2 x 2 nodes\n";
+					return;
+				}
+
+				// x / y expanded to every node (built once), z wrapped by set_z
+				Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+				nodeX.resize(rows * cols);
+				nodeY.resize(rows * cols);
+				parallel_for(rows, 0, [&](size_t j) {
+					for (size_t i = 0; i < cols; i++) {
+						nodeX[j * cols + i] = x[i];
+						nodeY[j * cols + i] = y[j];
+					}
+				});
+				Instrumentation::count_column(2 * rows * cols * sizeof(float));
+
+				// Strided views stay the caller's (see make_float_column)
+				if (x.stride == 1) {
+					release_unwrapped(x, mode);
+				}
+				if (y.stride == 1) {
+					release_unwrapped(y, mode);
+				}
+
+				soa = vtkSmartPointer<vtkSOADataArrayTemplate<float>>::New();
+				soa->SetNumberOfComponents(spatial_dimensions);
+				soa->SetArray(X_axis, nodeX.data(), static_cast<vtkIdType>(rows * cols), true, true);
+				soa->SetArray(Y_axis, nodeY.data(), static_cast<vtkIdType>(rows * cols), true, true);
+				heights = vtkSmartPointer<vtkFloatArray>::New();
+				heights->SetName("Height");
+
+				vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+				points->SetData(soa);
+				surface = vtkSmartPointer<vtkPolyData>::New();
+				surface->SetPoints(points);
+				surface->SetStrips(make_strips());
+				table_timer.stop();
+
+				Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+				lookup = vtkSmartPointer<vtkLookupTable>::New();
+				fill_lookup(map);
+
+				mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+				mapper->SetInputData(surface);
+				mapper->SetLookupTable(lookup);
+				mapper->SetScalarModeToUsePointData();
+				mapper->SetColorModeToMapScalars();
+				mapper->ScalarVisibilityOn();
+
+				actor = vtkSmartPointer<vtkActor>::New();
+				actor->SetMapper(mapper);
+
+				renderer = vtkSmartPointer<vtkRenderer>::New();
+				renderer->AddActor(actor);
+				renderer->SetBackground(named_colours()->GetColor3d(BackgroundColour).GetData());
+
+				// Headless targets render into their own (or the target's) offscreen window, otherwise a normal window
+				window = target.window;
+				if (!window) {
+					window = target.offscreen() ? offscreen_window(target.width, target.height) : vtkSmartPointer<vtkRenderWindow>::New();
+				}
+				window->SetSize(target.width, target.height);
+				window->AddRenderer(renderer);
+				layout.stop();
+
+				ready = set_z(z, mode);
+				renderer->ResetCamera();
+			}
+
+			~Surface() {
+				if (window) {
+					window->RemoveRenderer(renderer);
+				}
+			}
+
+			/* False when the grid was rejected (see std::cerr), the surface then does nothing */
+			bool valid() const { return ready; }
+
+			/* New heights (same grid): z and the colour scalars are rewrapped, the strips and x / y are kept */
+			bool set_z(series_view z, Ingestion mode = COPY) {
+
+				if (!surface || !grid_size_check("Surface::set_z", z.size)) { return false; }
+
+				Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+				const vtkIdType nodes = static_cast<vtkIdType>(rows * cols);
+				float* values = const_cast<float*>(z.data);
+
+				// Other layouts and value types go through a copy kept here
+				if (!z.contiguous() || mode == COPY) {
+					copy.resize(rows * cols);
+					parallel_for((z.size + chunk - 1) / chunk, 0, [&](size_t c) {
+						for (size_t i = c * chunk; i < z.size && i < (c + 1) * chunk; i++) {
+							copy[i] = z[i];
+						}
+					});
+					Instrumentation::count_column(z.size * sizeof(float));
+					if (mode != COPY && z.stride == 1) {
+						release_unwrapped(z, mode);
+					}
+					values = copy.data();
+					mode = BORROW;
+				}
+
+				// The scalars never own the memory, the z component does when it is handed over (so rewrap the scalars first)
+				heights->SetArray(values, nodes, 1);
+				surface->GetPointData()->SetScalars(heights);
+				if (mode == BORROW) {
+					soa->SetArray(Z_axis, values, nodes, true, true);
+				}
+				else {
+					soa->SetArray(Z_axis, values, nodes, true, false, vtkAbstractArray::VTK_DATA_ARRAY_DELETE);
+				}
+				Instrumentation::count_column(0);
+				soa->Modified();
+				heights->Modified();
+				surface->Modified();
+				table_timer.stop();
+
+				if (autorange) {
+					scan_range(values);
+				}
+				mapper->SetScalarRange(range[0], range[1]);
+				return true;
+			}
+
+			/* Heights mapped to the ends of the colour map. set_auto_range goes back to the min / max of every update. */
+			void set_range(double lo, double hi) {
+				if (!ready) { return; }
+				autorange = false;
+				range[0] = lo;
+				range[1] = hi;
+				mapper->SetScalarRange(lo, hi);
+			}
+
+			void set_auto_range() {
+				if (!ready) { return; }
+				autorange = true;
+				scan_range(soa->GetComponentArrayPointer(Z_axis));
+				mapper->SetScalarRange(range[0], range[1]);
+			}
+
+			void set_colour_map(Colour_map map) {
+				if (!ready) { return; }
+				fill_lookup(map);
+			}
+
+			/* Draw one frame (to the window or the headless target) */
+			bool render() {
+
+				if (!ready) { return false; }
+				Instrumentation::Scope instrumentation("_3D::Surface::render");
+				Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
+				renderer->ResetCameraClippingRange();
+				window->Render();
+				return target.offscreen() ? capture(window, target) : true;
+			}
+
+			/* Interactive loop (blocks until the window is closed) */
+			void show() {
+
+				if (!ready) { return; }
+				if (target.offscreen()) {
+					std::cerr << "W_VTK::_3D::Surface: show() needs an interactive (WINDOW) target\n";
+					return;
+				}
+				vtkSmartPointer<vtkRenderWindowInteractor> windowInteractor = vtkSmartPointer<vtkRenderWindowInteractor>::New();
+				vtkSmartPointer<vtkInteractorStyleTrackballCamera> style = vtkSmartPointer<vtkInteractorStyleTrackballCamera>::New();
+				windowInteractor->SetInteractorStyle(style);
+				windowInteractor->SetRenderWindow(window);
+				window->Render();
+				windowInteractor->Initialize();
+				windowInteractor->Start();
+			}
+
+			vtkPolyData* get_surface() const { return surface; }
+			vtkActor* get_actor() const { return actor; }
+			vtkRenderer* get_renderer() const { return renderer; }
+			vtkRenderWindow* get_window() const { return window; }
+
+		private:
+
+			Surface(const Surface&) = delete;
+			Surface& operator=(const Surface&) = delete;
+
+			static constexpr size_t chunk = 1 << 16;
+
+			bool grid_size_check(const char* caller, size_t heights) const {
+
+				if (heights != rows * cols) {
+					std::cerr << "W_VTK::_3D::" << caller << ": z has " << heights << " entries, expected " << rows << " x " << cols << "\n";
+					return false;
+				}
+				return true;
+			}
+
+			/* Strip j runs along rows j and j + 1: (j, 0), (j + 1, 0), (j, 1), (j + 1, 1), ... so 2 * cols ids per strip */
+			vtkSmartPointer<vtkCellArray> make_strips() const {
+
+				const size_t strips = rows - 1;
+				const size_t length = 2 * cols;
+
+				vtkSmartPointer<vtkIdTypeArray> starts = vtkSmartPointer<vtkIdTypeArray>::New();
+				starts->SetNumberOfTuples(static_cast<vtkIdType>(strips + 1));
+				vtkIdType* start = starts->GetPointer(0);
+				for (size_t s = 0; s <= strips; s++) {
+					start[s] = static_cast<vtkIdType>(s * length);
+				}
+
+				vtkSmartPointer<vtkIdTypeArray> connectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+				connectivity->SetNumberOfTuples(static_cast<vtkIdType>(strips * length));
+				vtkIdType* ids = connectivity->GetPointer(0);
+				const size_t columns = cols;
+				parallel_for(strips, 0, [&](size_t j) {
+					vtkIdType* out = ids + j * length;
+					for (size_t i = 0; i < columns; i++) {
+						out[2 * i] = static_cast<vtkIdType>(j * columns + i);
+						out[2 * i + 1] = static_cast<vtkIdType>((j + 1) * columns + i);
+					}
+				});
+
+				vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+				cells->SetData(starts, connectivity);
+				return cells;
+			}
+
+			/* Colour map -> lookup table */
+			void fill_lookup(Colour_map map) {
+
+				unsigned char table[256][4];
+				colour_map_table(map, table);
+				lookup->SetNumberOfTableValues(256);
+				for (int i = 0; i < 256; i++) {
+					lookup->SetTableValue(i, table[i][0] / 255.0, table[i][1] / 255.0, table[i][2] / 255.0, 1.0);
+				}
+			}
+
+			/* Height range, chunks in parallel then reduced */
+			void scan_range(const float* values) {
+
+				const size_t nodes = rows * cols;
+				const size_t chunks = (nodes + chunk - 1) / chunk;
+				std::vector<float> lo(chunks), hi(chunks);
+				parallel_for(chunks, 0, [&](size_t c) {
+					const size_t first = c * chunk;
+					LOD::min_max(values + first, (std::min)(chunk, nodes - first), lo[c], hi[c]);
+				});
+				range[0] = *std::min_element(lo.begin(), lo.end());
+				range[1] = *std::max_element(hi.begin(), hi.end());
+			}
+
+			RenderTarget target;
+			size_t rows, cols;
+			std::vector<float> nodeX, nodeY;		// x / y at every node
+			std::vector<float> copy;				// z when it can't be wrapped
+			double range[2];
+			bool autorange, ready;
+			vtkSmartPointer<vtkSOADataArrayTemplate<float>> soa;
+			vtkSmartPointer<vtkFloatArray> heights;
+			vtkSmartPointer<vtkPolyData> surface;
+			vtkSmartPointer<vtkLookupTable> lookup;
+			vtkSmartPointer<vtkPolyDataMapper> mapper;
+			vtkSmartPointer<vtkActor> actor;
+			vtkSmartPointer<vtkRenderer> renderer;
+			vtkSmartPointer<vtkRenderWindow> window;
+		};
+
+		/*=================================================================================================================
+		Plot z = f(x, y) over a grid (x -> cols values, y -> rows values, z -> rows * cols heights, row major) coloured by height.
+		False when the grid is rejected (see std::cerr) or the headless image isn't written.
+		=================================================================================================================== */
+		inline bool Surface_plotter(series_view x, series_view y, series_view z, Colour_map map = VIRIDIS, const char* BackgroundColour = "White", Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
+
+			Instrumentation::Scope instrumentation("_3D::Surface_plotter");
+
+			Surface surface(x, y, z, map, BackgroundColour, mode, target);
+			if (!surface.valid()) { return false; }
+
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return surface.render();
+			}
+
+			// Render the scene
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
+			surface.get_window()->Render();
+			render_timer.stop();
+			instrumentation.finish();
+			surface.show();
+			return true;
+		}
+
+		/* Static memory variant: z[rows][cols] is wrapped as it is (no copy with BORROW) */
+		template<int rows, int cols>
+		void Surface_plotter(float(&x)[cols], float(&y)[rows], float(&z)[rows][cols], Colour_map map = VIRIDIS, const char* BackgroundColour = "White", Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
+
+			Surface_plotter(series_view(x, cols), series_view(y, rows), series_view(&z[0][0], static_cast<size_t>(rows) * cols), map, BackgroundColour, mode, target);
+		}
+	}
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+/* ==================================================================================================
+ ------------ Trajectories: many 3D polylines (e.g. particle tracks) as one dataset and one draw -----
+ ==================================================================================================*/
+
+/* VTK Library files */
+#include <vtkSmartPointer.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkIdTypeArray.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkActor.h>
+#include <vtkProperty.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkInteractorStyleTrackballCamera.h>
+
+/* Wrapper modules */
+#include "VTK_columns.h"
+#include "VTK_output.h"
+#include "VTK_colours.h"
+#include "VTK_instrumentation.h"
+#include "VTK_parallel.h"
+#include "VTK_3D_plotter.h"
+#include "VTK_point_cloud.h"
+
+/* External modules */
+#include <vector>
+#include <iostream>
+
+
+// Namespace "wrapped visualization toolkit"
+namespace W_VTK {
+
+	namespace _3D {
+
+		/* ----- Notes -----:
+		Plotting N tracks with the chart Line_plotter means N tables, 3N collumns and N vtkPlotLine3D that the chart walks
+		every frame. Trajectory_plotter takes every track at once:
+			x, y, z		-> all tracks' points one after the other (concatenated)
+			offsets		-> where each track starts, plus the end: track t is points [offsets[t], offsets[t + 1]), so
+						   offsets.size() = tracks + 1, offsets.front() = 0 and offsets.back() = number of points
+		and builds ONE vtkPolyData: the points wrap the data (see make_points, no copy), one polyline cell per track (the
+		connectivity is just 0 .. points - 1 as the tracks are already in order) and one colour per track as cell data.
+		One mapper and one actor draw it, so set up and per frame cost go with the number of points, not tracks.
+		LineColourName nullptr -> every track gets the next palette colour (seed with Palette::set_default_seed). */
+
+		/* Offsets must start at 0, never decrease and end at the number of points */
+		inline bool offsets_check(const std::vector<size_t>& offsets, size_t points) {
+
+			bool valid = !offsets.empty() && offsets.front() == 0 && offsets.back() == points;
+			for (size_t t = 1; valid && t < offsets.size(); t++) {
+				valid = (offsets[t] >= offsets[t - 1]);
+			}
+			if (!valid) {
+				std::cerr << "W_VTK::_3D::Trajectory_plotter: offsets must start at 0, never decrease and end at " << points << "\n";
+			}
+			return valid;
+		}
+
+		/* Polylines over points that are already in track order: offsets copied as vtkIdType, connectivity 0 .. points - 1 */
+		inline vtkSmartPointer<vtkCellArray> make_polylines(const std::vector<size_t>& offsets, unsigned threads = 0) {
+
+			const size_t points = offsets.back();
+
+			vtkSmartPointer<vtkIdTypeArray> starts = vtkSmartPointer<vtkIdTypeArray>::New();
+			starts->SetNumberOfTuples(static_cast<vtkIdType>(offsets.size()));
+			vtkIdType* start = starts->GetPointer(0);
+			for (size_t t = 0; t < offsets.size(); t++) {
+				start[t] = static_cast<vtkIdType>(offsets[t]);
+			}
+
+			vtkSmartPointer<vtkIdTypeArray> connectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+			connectivity->SetNumberOfTuples(static_cast<vtkIdType>(points));
+			vtkIdType* ids = connectivity->GetPointer(0);
+			const size_t chunk = 1 << 20;
+			parallel_for((points + chunk - 1) / chunk, threads, [&](size_t c) {
+				const size_t end = (c + 1) * chunk < points ? (c + 1) * chunk : points;
+				for (size_t i = c * chunk; i < end; i++) {
+					ids[i] = static_cast<vtkIdType>(i);
+				}
+			});
+
+			vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+			lines->SetData(starts, connectivity);
+			return lines;
+		}
+
+		/*=================================================================================================================
+		Plot many 3D lines in one draw. False when the data is rejected (see std::cerr) or the headless image isn't written.
+		=================================================================================================================== */
+		inline bool Trajectory_plotter(series_view x, series_view y, series_view z, const std::vector<size_t>& offsets, const char* LineColourName, const char* BackgroundColour, float width, Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
+
+			Instrumentation::Scope instrumentation("_3D::Trajectory_plotter");
+			if (!axis_size_check(x, y, z)) { return false; }
+			if (!offsets_check(offsets, x.size)) { return false; }
+
+			const size_t tracks = offsets.size() - 1;
+
+			// Named colours
+			const Colour_table* colors = named_colours();
+
+			// Points over the data, one polyline per track
+			Instrumentation::Stage_timer table_timer(Instrumentation::TABLE);
+			vtkSmartPointer<vtkPolyData> trajectories = vtkSmartPointer<vtkPolyData>::New();
+			trajectories->SetPoints(make_points(x, y, z, mode));
+			trajectories->SetLines(make_polylines(offsets));
+
+			// One RGB colour per track (cell)
+			vtkSmartPointer<vtkUnsignedCharArray> trackColours = vtkSmartPointer<vtkUnsignedCharArray>::New();
+			trackColours->SetName("Track colours");
+			trackColours->SetNumberOfComponents(3);
+			trackColours->SetNumberOfTuples(static_cast<vtkIdType>(tracks));
+			unsigned char* rgb = trackColours->GetPointer(0);
+			Palette palette;
+			const vtkColor3d named = colors->GetColor3d(LineColourName ? LineColourName : "Black");
+			for (size_t t = 0; t < tracks; t++) {
+				const vtkColor3d colour = LineColourName ? named : palette.next();
+				for (int c = 0; c < 3; c++) {
+					rgb[3 * t + c] = static_cast<unsigned char>(colour.GetData()[c] * 255.0 + 0.5);
+				}
+			}
+			trajectories->GetCellData()->SetScalars(trackColours);
+			table_timer.stop();
+
+			Instrumentation::Stage_timer layout(Instrumentation::LAYOUT);
+			vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+			mapper->SetInputData(trajectories);
+			mapper->ScalarVisibilityOn();
+			mapper->SetScalarModeToUseCellData();
+			mapper->SetColorModeToDirectScalars();
+
+			vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+			actor->SetMapper(mapper);
+			actor->GetProperty()->SetLineWidth(width);
+
+			vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+			renderer->AddActor(actor);
+			renderer->SetBackground(colors->GetColor3d(BackgroundColour).GetData());
+			renderer->ResetCamera();
+			layout.stop();
+
+			// Headless: straight to the image
+			if (target.offscreen()) {
+				return render_offscreen(renderer, target);
+			}
+
+			vtkSmartPointer<vtkRenderWindow> window = vtkSmartPointer<vtkRenderWindow>::New();
+			window->SetSize(640, 480);
+			window->AddRenderer(renderer);
+
+			vtkSmartPointer<vtkRenderWindowInteractor> interactor = vtkSmartPointer<vtkRenderWindowInteractor>::New();
+			vtkSmartPointer<vtkInteractorStyleTrackballCamera> style = vtkSmartPointer<vtkInteractorStyleTrackballCamera>::New();
+			interactor->SetInteractorStyle(style);
+			interactor->SetRenderWindow(window);
+
+			// Render the scene
+			Instrumentation::Stage_timer render_timer(Instrumentation::RENDER);
+			window->Render();
+			render_timer.stop();
+			instrumentation.finish();
+			interactor->Initialize();
+			interactor->Start();
+			return true;
+		}
+
+		/* Tracks of equal length in one block: data[spatial_dimensions][numPoints], track after track, pointsPerTrack points each
+		(numPoints must be a whole number of tracks) */
+		template <int numPoints>
+		bool Trajectory_plotter(float(&data)[spatial_dimensions][numPoints], size_t pointsPerTrack, const char* LineColourName, const char* BackgroundColour, float width, Ingestion mode = BORROW, const RenderTarget& target = RenderTarget()) {
+
+			if (pointsPerTrack == 0 || numPoints % pointsPerTrack != 0) {
+				std::cerr << "W_VTK::_3D::Trajectory_plotter: " << numPoints << " points don't split into tracks of " << pointsPerTrack << "\n";
+				return false;
+			}
+			const size_t numTracks = numPoints / pointsPerTrack;
+
+			std::vector<size_t> offsets(numTracks + 1);
+			for (size_t t = 0; t <= numTracks; t++) {
+				offsets[t] = t * pointsPerTrack;
+			}
+			return Trajectory_plotter(series_view(data[X_axis], numPoints), series_view(data[Y_axis], numPoints), series_view(data[Z_axis], numPoints), offsets, LineColourName, BackgroundColour, width, as_block(mode), target);
+		}
+	}
+}
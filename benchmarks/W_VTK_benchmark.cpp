@@ -0,0 +1,437 @@
+/* ==================================================================================================
+ ------------------ Benchmarks: ingestion, pipeline update and first frame latency ------------------
+ ==================================================================================================*/
+
+/* ----- Notes -----:
+Every _2D / _3D Line_plotter and Scatter_plotter overload (and the _2D multi-line / histogram, _3D point cloud / trajectory plotters) is run headless
+(RGBA target, nothing is written to disk) over a grid of point counts (1e3 .. 1e8) and series counts (1 .. 1e4).
+For each case five numbers are recorded:
+	conversion_s	-> level of detail / binning / reshaping the data before VTK sees it
+	table_s			-> building the vtkTable collumns from the raw data
+	update_s		-> adding the plots to a chart and updating it (VTK builds its per plot caches here)
+	first_frame_s	-> the first offscreen render of that chart
+	end_to_end_s	-> the overload itself, called as a user would
+plus the process' peak RSS so far. The stage numbers are the plotters' own instrumentation (see VTK_instrumentation.h) of
+that same call, summed over every plot it makes (e.g. the chart variants and multiplot_view_window). They are 0 when built
+with W_VTK_NO_INSTRUMENTATION.
+The fixed size (template) overloads need compile time sizes so they run at one size (see TEMPLATE_POINTS / TEMPLATE_SERIES).
+Cases over the point budget (points * series, default 1e8) are skipped so a full run fits in memory.
+Results go to stdout (or --out file) as JSON.
+
+Build against the VTK install used for the library, e.g. with VTK 9:
+	g++ -O2 -std=c++17 -I.. -I/usr/include/vtk-9.1 W_VTK_benchmark.cpp -o W_VTK_benchmark \
+		-lvtkChartsCore-9.1 -lvtkViewsContext2D-9.1 -lvtkRenderingContext2D-9.1 -lvtkRenderingContextOpenGL2-9.1 \
+		-lvtkRenderingOpenGL2-9.1 -lvtkRenderingFreeType-9.1 -lvtkRenderingCore-9.1 -lvtkInteractionStyle-9.1 \
+		-lvtkIOImage-9.1 -lvtkCommonColor-9.1 -lvtkCommonDataModel-9.1 -lvtkCommonCore-9.1 -lpthread
+
+Usage:
+	W_VTK_benchmark [--max-points N] [--max-series N] [--budget N] [--out results.json] */
+
+/* VTK Library files */
+#include <vtkAutoInit.h>
+VTK_MODULE_INIT(vtkRenderingOpenGL2);
+VTK_MODULE_INIT(vtkRenderingContextOpenGL2);
+VTK_MODULE_INIT(vtkRenderingFreeType);
+VTK_MODULE_INIT(vtkInteractionStyle);
+
+/* Wrapper modules */
+#include "VTK_2D_plotter.h"
+#include "VTK_multi_line.h"
+#include "VTK_histogram.h"
+#include "VTK_3D_plotter.h"
+#include "VTK_output.h"
+#include "VTK_point_cloud.h"
+#include "VTK_trajectories.h"
+#include "VTK_instrumentation.h"
+
+/* External modules */
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <functional>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace W_VTK;
+
+/* Size the fixed size overloads are instantiated at */
+enum {
+	TEMPLATE_POINTS = 1000, TEMPLATE_SERIES = 8
+};
+
+/* ---------------------------------------------- Measuring helpers ---------------------------------------------- */
+
+typedef std::chrono::steady_clock Clock;
+
+double seconds_since(Clock::time_point start) {
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double time_it(const std::function<void()>& f) {
+	const Clock::time_point start = Clock::now();
+	f();
+	return seconds_since(start);
+}
+
+/* Peak resident set size of the process so far, in bytes */
+unsigned long long peak_rss_bytes() {
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return static_cast<unsigned long long>(counters.PeakWorkingSetSize);
+	}
+	return 0;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+	return static_cast<unsigned long long>(usage.ru_maxrss);			// bytes on macOS
+#else
+	return static_cast<unsigned long long>(usage.ru_maxrss) * 1024ULL;	// kilobytes on Linux
+#endif
+#endif
+}
+
+/* One JSON record per overload and size */
+struct Record {
+	std::string overload;
+	size_t points, series;
+	double conversion_s, table_s, update_s, first_frame_s, end_to_end_s;
+	unsigned long long peak_rss;
+};
+
+std::string to_json(const std::vector<Record>& records) {
+
+	std::ostringstream out;
+	out << "{\n  \"benchmark\": \"W_VTK\",\n  \"results\": [\n";
+	for (size_t i = 0; i < records.size(); i++) {
+		const Record& r = records[i];
+		out << "    {\"overload\": \"" << r.overload << "\", \"points\": " << r.points << ", \"series\": " << r.series
+			<< ", \"conversion_s\": " << r.conversion_s << ", \"table_s\": " << r.table_s << ", \"update_s\": " << r.update_s << ", \"first_frame_s\": " << r.first_frame_s
+			<< ", \"end_to_end_s\": " << r.end_to_end_s << ", \"peak_rss_bytes\": " << r.peak_rss << "}"
+			<< (i + 1 < records.size() ? ",\n" : "\n");
+	}
+	out << "  ]\n}\n";
+	return out.str();
+}
+
+/* ---------------------------------------------- Test data ---------------------------------------------- */
+
+struct Data {
+	std::vector<float> x;						// Shared, sorted x
+	std::vector<std::vector<float>> y;			// One row per series
+	std::vector<series_view> xs, ys;			// Views: xs repeats x per series for the different X overloads
+	std::vector<std::string> names;
+};
+
+Data make_data(size_t points, size_t series) {
+
+	Data d;
+	d.x.resize(points);
+	for (size_t i = 0; i < points; i++) {
+		d.x[i] = static_cast<float>(i);
+	}
+	d.y.resize(series);
+	for (size_t j = 0; j < series; j++) {
+		d.y[j].resize(points);
+		for (size_t i = 0; i < points; i++) {
+			d.y[j][i] = std::sin(0.001f * i + j) + 0.01f * j;
+		}
+		d.xs.push_back(series_view(d.x));
+		d.ys.push_back(series_view(d.y[j]));
+		d.names.push_back("Series " + std::to_string(j));
+	}
+	return d;
+}
+
+/* ---------------------------------------------- Overloads, end to end ---------------------------------------------- */
+
+/* Stats of every plot made during one measured call, summed: a chart variant call is several plots and a
+   multiplot_view_window, each reporting its own stages */
+Instrumentation::Stats measured;
+
+void add_stats(const Instrumentation::Stats& stats, void*) {
+	for (int s = 0; s < Instrumentation::NUM_STAGES; s++) {
+		measured.seconds[s] += stats.seconds[s];
+	}
+}
+
+/* Runs one overload call as a user would. The stages come from the instrumentation of that same call. */
+Record measure(const std::string& overload, const Data& d, const std::function<void()>& call) {
+
+	measured.clear();
+	Instrumentation::set_callback(add_stats);
+	const double end_to_end = time_it(call);
+	Instrumentation::set_callback(nullptr);
+
+	Record r;
+	r.overload = overload;
+	r.points = d.x.size();
+	r.series = d.ys.size();
+	r.conversion_s = measured.seconds[Instrumentation::CONVERSION];
+	r.table_s = measured.seconds[Instrumentation::TABLE];
+	r.update_s = measured.seconds[Instrumentation::LAYOUT];
+	r.first_frame_s = measured.seconds[Instrumentation::RENDER];
+	r.end_to_end_s = end_to_end;
+	r.peak_rss = peak_rss_bytes();
+	return r;
+}
+
+/* Runtime sized overloads at one size */
+void run_runtime(const Data& d, std::vector<Record>& out) {
+
+	std::vector<unsigned char> pixels;
+	const RenderTarget target = RenderTarget::Rgba(pixels);
+
+	// ----- 2D lines -----
+	out.push_back(measure("_2D::Line_plotter(names, x, data)", d, [&]() {
+		_2D::Line_plotter(d.names, series_view(d.x), d.ys, BORROW, LOD::Settings(), target);
+	}));
+
+	out.push_back(measure("_2D::Line_plotter(names, x[], data[])", d, [&]() {
+		_2D::Line_plotter(d.names, d.xs, d.ys, BORROW, LOD::Settings(), target);
+	}));
+
+	out.push_back(measure("_2D::Line_plotter(chart, x, data)", d, [&]() {
+		vtkSmartPointer<vtkChartXY> chart = _2D::multiplot_chart_instantiation();
+		for (size_t j = 0; j < d.ys.size(); j++) {
+			_2D::Line_plotter(chart, d.xs[j], d.ys[j], d.names[j], "Black", 1.0f, BORROW);
+		}
+		_2D::multiplot_view_window(chart, "White", false, target);
+	}));
+
+	// ----- 2D lines as one Multi_line_plot -----
+	out.push_back(measure("_2D::Multi_line_plotter(names, x, data)", d, [&]() {
+		_2D::Multi_line_plotter(d.names, series_view(d.x), d.ys, nullptr, BORROW, target);
+	}));
+
+	// ----- 2D scatter -----
+	out.push_back(measure("_2D::Scatter_plotter(names, x, data)", d, [&]() {
+		_2D::Scatter_plotter(d.names, series_view(d.x), d.ys, BORROW, target);
+	}));
+
+	out.push_back(measure("_2D::Scatter_plotter(names, x[], data[])", d, [&]() {
+		_2D::Scatter_plotter(d.names, d.xs, d.ys, BORROW, target);
+	}));
+
+	out.push_back(measure("_2D::Scatter_plotter(chart, x, data)", d, [&]() {
+		vtkSmartPointer<vtkChartXY> chart = _2D::multiplot_chart_instantiation();
+		for (size_t j = 0; j < d.ys.size(); j++) {
+			_2D::Scatter_plotter(chart, d.xs[j], d.ys[j], d.names[j], "Black", 1.0f, _2D::CIRCLE, BORROW);
+		}
+		_2D::multiplot_view_window(chart, "White", false, target);
+	}));
+
+	// ----- Histogram of every series' samples as one (what the scatters above are often used for) -----
+	std::vector<float> samples;
+	for (size_t j = 0; j < d.y.size(); j++) {
+		samples.insert(samples.end(), d.y[j].begin(), d.y[j].end());
+	}
+	out.push_back(measure("_2D::Histogram_plotter(name, samples)", d, [&]() {
+		_2D::Histogram_plotter("samples", samples, Histogram::Settings(), "SteelBlue", target);
+	}));
+
+	// ----- 3D (one series, the second row is used as Z) -----
+	const series_view z = d.ys[d.ys.size() > 1 ? 1 : 0];
+
+	out.push_back(measure("_3D::Line_plotter(x, y, z)", d, [&]() {
+		_3D::Line_plotter(series_view(d.x), d.ys[0], z, "Black", "White", 1.0f, BORROW, target);
+	}));
+
+	out.push_back(measure("_3D::Line_plotter(chart, x, y, z)", d, [&]() {
+		vtkSmartPointer<vtkChartXYZ> chart = _3D::multiplot_chart_instantiation();
+		_3D::Line_plotter(chart, series_view(d.x), d.ys[0], z, "Black", 1.0f, BORROW);
+		_3D::multiplot_view_window(chart, "White", target);
+	}));
+
+	out.push_back(measure("_3D::Scatter_plotter(x, y, z)", d, [&]() {
+		_3D::Scatter_plotter(series_view(d.x), d.ys[0], z, "Black", "White", 1.0f, BORROW, target);
+	}));
+
+	out.push_back(measure("_3D::Scatter_plotter(chart, x, y, z)", d, [&]() {
+		vtkSmartPointer<vtkChartXYZ> chart = _3D::multiplot_chart_instantiation();
+		_3D::Scatter_plotter(chart, series_view(d.x), d.ys[0], z, "Black", 1.0f, BORROW);
+		_3D::multiplot_view_window(chart, "White", target);
+	}));
+
+	// ----- 3D point cloud -----
+	out.push_back(measure("_3D::Point_cloud_plotter(x, y, z)", d, [&]() {
+		_3D::Point_cloud_plotter(series_view(d.x), d.ys[0], z, "Black", "White", 1.0f, BORROW, LOD::Cloud_settings(), target);
+	}));
+
+	// ----- 3D trajectories: every series is one track (x, series, series), concatenated -----
+	std::vector<float> tracksX, tracksY;
+	std::vector<size_t> offsets(1, 0);
+	for (size_t j = 0; j < d.y.size(); j++) {
+		tracksX.insert(tracksX.end(), d.x.begin(), d.x.end());
+		tracksY.insert(tracksY.end(), d.y[j].begin(), d.y[j].end());
+		offsets.push_back(tracksY.size());
+	}
+	out.push_back(measure("_3D::Trajectory_plotter(x, y, z, offsets)", d, [&]() {
+		_3D::Trajectory_plotter(tracksX, tracksY, tracksY, offsets, nullptr, "White", 1.0f, BORROW, target);
+	}));
+}
+
+/* Fixed size overloads (one size, see TEMPLATE_POINTS / TEMPLATE_SERIES) and the single point scatters */
+void run_templates(std::vector<Record>& out) {
+
+	typedef float Rows[TEMPLATE_SERIES][TEMPLATE_POINTS];
+	typedef float Axes[_3D::spatial_dimensions][TEMPLATE_POINTS];
+
+	const Data d = make_data(TEMPLATE_POINTS, TEMPLATE_SERIES);
+
+	// Heap blocks viewed as the C-arrays the templates take
+	std::vector<float> xBlock(d.x), xRowsBlock(TEMPLATE_SERIES * TEMPLATE_POINTS), rowsBlock(TEMPLATE_SERIES * TEMPLATE_POINTS);
+	std::vector<float> axesBlock(_3D::spatial_dimensions * TEMPLATE_POINTS);
+	for (int j = 0; j < TEMPLATE_SERIES; j++) {
+		std::memcpy(&xRowsBlock[j * TEMPLATE_POINTS], d.x.data(), TEMPLATE_POINTS * sizeof(float));
+		std::memcpy(&rowsBlock[j * TEMPLATE_POINTS], d.y[j].data(), TEMPLATE_POINTS * sizeof(float));
+	}
+	for (int a = 0; a < _3D::spatial_dimensions; a++) {
+		std::memcpy(&axesBlock[a * TEMPLATE_POINTS], d.y[a].data(), TEMPLATE_POINTS * sizeof(float));
+	}
+	float(&x)[TEMPLATE_POINTS] = *reinterpret_cast<float(*)[TEMPLATE_POINTS]>(xBlock.data());
+	Rows& xRows = *reinterpret_cast<Rows*>(xRowsBlock.data());
+	Rows& rows = *reinterpret_cast<Rows*>(rowsBlock.data());
+	Axes& axes = *reinterpret_cast<Axes*>(axesBlock.data());
+
+	std::string names[TEMPLATE_SERIES];
+	std::string pairedNames[2 * TEMPLATE_SERIES];
+	_2D::LineNameGenerator(names);
+	_2D::LineNameGenerator(pairedNames);
+
+	std::vector<unsigned char> pixels;
+	const RenderTarget target = RenderTarget::Rgba(pixels);
+
+	out.push_back(measure("_2D::Line_plotter<numPoints, numLines>(names, x, data)", d, [&]() {
+		_2D::Line_plotter(names, x, rows, COPY, LOD::Settings(), target);
+	}));
+
+	out.push_back(measure("_2D::Line_plotter<numPoints, numLines>(names, x[][], data[][])", d, [&]() {
+		_2D::Line_plotter<TEMPLATE_POINTS, TEMPLATE_SERIES>(pairedNames, xRows, rows, COPY, LOD::Settings(), target);
+	}));
+
+	out.push_back(measure("_2D::Line_plotter<numPoints>(chart, x, data)", d, [&]() {
+		vtkSmartPointer<vtkChartXY> chart = _2D::multiplot_chart_instantiation();
+		for (int j = 0; j < TEMPLATE_SERIES; j++) {
+			_2D::Line_plotter(chart, x, rows[j], names[j], "Black", 1.0f);
+		}
+		_2D::multiplot_view_window(chart, "White", false, target);
+	}));
+
+	out.push_back(measure("_2D::Scatter_plotter<numPoints, numDataSets>(names, x, data)", d, [&]() {
+		_2D::Scatter_plotter(names, x, rows, COPY, target);
+	}));
+
+	out.push_back(measure("_2D::Scatter_plotter<numPoints, numDataSets>(names, x[][], data[][])", d, [&]() {
+		_2D::Scatter_plotter<TEMPLATE_POINTS, TEMPLATE_SERIES>(pairedNames, xRows, rows, COPY, target);
+	}));
+
+	out.push_back(measure("_2D::Scatter_plotter<numPoints>(chart, x, data)", d, [&]() {
+		vtkSmartPointer<vtkChartXY> chart = _2D::multiplot_chart_instantiation();
+		for (int j = 0; j < TEMPLATE_SERIES; j++) {
+			_2D::Scatter_plotter(chart, x, rows[j], names[j], "Black", 1.0f, _2D::CIRCLE);
+		}
+		_2D::multiplot_view_window(chart, "White", false, target);
+	}));
+
+	out.push_back(measure("_2D::Scatter_plotter(chart, x, y) per point", d, [&]() {
+		vtkSmartPointer<vtkChartXY> chart = _2D::multiplot_chart_instantiation();
+		for (int i = 0; i < TEMPLATE_POINTS; i++) {
+			_2D::Scatter_plotter(chart, x[i], rows[0][i], names[0], "Black", 1.0f, _2D::CIRCLE);
+		}
+		_2D::multiplot_view_window(chart, "White", false, target);
+	}));
+
+	out.push_back(measure("_3D::Line_plotter<numPoints>(data)", d, [&]() {
+		_3D::Line_plotter(axes, "Black", "White", 1.0f, COPY, target);
+	}));
+
+	out.push_back(measure("_3D::Line_plotter<numPoints>(chart, data)", d, [&]() {
+		vtkSmartPointer<vtkChartXYZ> chart = _3D::multiplot_chart_instantiation();
+		_3D::Line_plotter(chart, axes, "Black", 1.0f);
+		_3D::multiplot_view_window(chart, "White", target);
+	}));
+
+	out.push_back(measure("_3D::Scatter_plotter<numPoints>(data)", d, [&]() {
+		_3D::Scatter_plotter(axes, "Black", "White", 1.0f, COPY, target);
+	}));
+
+	out.push_back(measure("_3D::Scatter_plotter<numPoints>(chart, data)", d, [&]() {
+		vtkSmartPointer<vtkChartXYZ> chart = _3D::multiplot_chart_instantiation();
+		_3D::Scatter_plotter(chart, axes, "Black", 1.0f);
+		_3D::multiplot_view_window(chart, "White", target);
+	}));
+
+	out.push_back(measure("_3D::Scatter_plotter(chart, point) per point", d, [&]() {
+		vtkSmartPointer<vtkChartXYZ> chart = _3D::multiplot_chart_instantiation();
+		float point[_3D::spatial_dimensions];
+		for (int i = 0; i < TEMPLATE_POINTS; i++) {
+			point[_3D::X_axis] = axes[_3D::X_axis][i];
+			point[_3D::Y_axis] = axes[_3D::Y_axis][i];
+			point[_3D::Z_axis] = axes[_3D::Z_axis][i];
+			_3D::Scatter_plotter(chart, point, "Black", 1.0f);
+		}
+		_3D::multiplot_view_window(chart, "White", target);
+	}));
+}
+
+/* ---------------------------------------------- Main ---------------------------------------------- */
+
+int main(int argc, char** argv) {
+
+	double maxPoints = 1e8, maxSeries = 1e4, budget = 1e8;
+	std::string outPath;
+
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (std::strcmp(argv[i], "--max-points") == 0) { maxPoints = std::atof(argv[i + 1]); }
+		else if (std::strcmp(argv[i], "--max-series") == 0) { maxSeries = std::atof(argv[i + 1]); }
+		else if (std::strcmp(argv[i], "--budget") == 0) { budget = std::atof(argv[i + 1]); }
+		else if (std::strcmp(argv[i], "--out") == 0) { outPath = argv[i + 1]; }
+		else {
+			std::cerr << "Unknown option " << argv[i] << "\n";
+			return 1;
+		}
+	}
+
+	std::vector<Record> records;
+
+	// Runtime sized overloads over the size grid (decades)
+	for (double points = 1e3; points <= maxPoints; points *= 10) {
+		for (double series = 1; series <= maxSeries; series *= 10) {
+
+			if (points * series > budget) {
+				continue;
+			}
+			std::cerr << "points " << points << ", series " << series << "\n";
+
+			const Data d = make_data(static_cast<size_t>(points), static_cast<size_t>(series));
+			run_runtime(d, records);
+		}
+	}
+
+	// Fixed size overloads
+	run_templates(records);
+
+	const std::string json = to_json(records);
+	if (outPath.empty()) {
+		std::cout << json;
+	}
+	else {
+		std::ofstream file(outPath.c_str());
+		file << json;
+	}
+	return 0;
+}